@@ -0,0 +1,101 @@
+#ifndef LAB0_BULK_H
+#define LAB0_BULK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "list.h"
+
+/**
+ * q_insert_head_bulk() - Insert many elements at the head of the queue
+ * @head: header of queue
+ * @sv: strings to copy
+ * @nsv: number of strings in @sv
+ * @n: number of elements to insert
+ *
+ * Element i holds a copy of sv[i % nsv], so @sv may list every string or
+ * hold a single one to be repeated @n times. The queue ends up as if
+ * q_insert_head() had been called for each element in turn.
+ *
+ * All nodes and strings are allocated in one block and linked privately
+ * before the chain is spliced in, so either all @n elements are inserted or
+ * none. The block is freed once every element in it has been released.
+ *
+ * Return: true for success, false if @head or @sv is NULL, @nsv is 0 or the
+ * block could not be allocated.
+ */
+bool q_insert_head_bulk(struct list_head *head,
+                        char *const *sv,
+                        size_t nsv,
+                        size_t n);
+
+/**
+ * q_insert_tail_bulk() - Insert many elements at the tail of the queue
+ * @head: header of queue
+ * @sv: strings to copy
+ * @nsv: number of strings in @sv
+ * @n: number of elements to insert
+ *
+ * Like q_insert_head_bulk(), but the queue ends up as if q_insert_tail() had
+ * been called for each element in turn.
+ *
+ * Return: true for success, false if @head or @sv is NULL, @nsv is 0 or the
+ * block could not be allocated.
+ */
+bool q_insert_tail_bulk(struct list_head *head,
+                        char *const *sv,
+                        size_t nsv,
+                        size_t n);
+
+/**
+ * q_splice_out() - Move a range of elements to a new queue
+ * @head: header of queue
+ * @from: position of the first element to move, counting from 0
+ * @to: position one past the last element to move
+ *
+ * The elements are relinked, not copied, so this takes O(n) pointer steps to
+ * find the ends of the range, from whichever end of the queue is nearer, and
+ * O(1) to move it. The moved elements keep their order.
+ *
+ * Return: the new queue, NULL if @head is NULL, [@from, @to) is not a range
+ * of the queue or the new queue could not be allocated.
+ */
+struct list_head *q_splice_out(struct list_head *head, int from, int to);
+
+/**
+ * q_remove_head_n() - Move the first @n elements to a new queue
+ * @head: header of queue
+ * @n: number of elements, all of them if the queue is shorter
+ *
+ * Return: the new queue, NULL if @head is NULL, @n is negative or the new
+ * queue could not be allocated.
+ */
+struct list_head *q_remove_head_n(struct list_head *head, int n);
+
+/**
+ * q_remove_tail_n() - Move the last @n elements to a new queue
+ * @head: header of queue
+ * @n: number of elements, all of them if the queue is shorter
+ *
+ * Return: the new queue, NULL if @head is NULL, @n is negative or the new
+ * queue could not be allocated.
+ */
+struct list_head *q_remove_tail_n(struct list_head *head, int n);
+
+/**
+ * q_compact() - Move all elements of the queue into one block
+ * @head: header of queue
+ *
+ * After sorting or shuffling, consecutive elements are scattered over the
+ * heap. This copies every element and its string, in list order, into a
+ * single block laid out like that of a bulk insertion, relinks the copies in
+ * place of the originals and releases the originals, so that later passes
+ * over the queue read memory sequentially. The elements keep their order and
+ * values, but not their addresses.
+ *
+ * Return: true for success, false if @head is NULL or the block could not be
+ * allocated, leaving the queue untouched.
+ */
+bool q_compact(struct list_head *head);
+
+#endif /* LAB0_BULK_H */
@@ -107,10 +107,39 @@ void add_param(char *name, int *valp, char *summary, setter_func_t setter)
     param->valp = valp;
     param->summary = summary;
     param->setter = setter;
+    param->names = NULL;
     param->next = next_param;
     *last_loc = param;
 }
 
+/* Add a new parameter with named values */
+void add_named_param(char *name,
+                     int *valp,
+                     char *const *names,
+                     char *summary,
+                     setter_func_t setter)
+{
+    add_param(name, valp, summary, setter);
+    param_element_t *param = param_list;
+    while (strcmp(param->name, name))
+        param = param->next;
+    param->names = names;
+}
+
+/* Parse the value of param given as an integer or as one of its names */
+static bool get_param_value(param_element_t *param, char *vname, int *loc)
+{
+    if (get_int(vname, loc))
+        return true;
+    for (int i = 0; param->names && param->names[i]; i++) {
+        if (!strcmp(param->names[i], vname)) {
+            *loc = i;
+            return true;
+        }
+    }
+    return false;
+}
+
 /* Parse a string into a command line */
 static char **parse_args(char *line, int *argcp)
 {
@@ -301,8 +330,16 @@ static bool do_option(int argc, char *argv[])
         param_element_t *plist = param_list;
         report(1, "Options:");
         while (plist) {
-            report(1, "  %-12s%-12d | %s", plist->name, *plist->valp,
-                   plist->summary);
+            int v = *plist->valp;
+            bool named = plist->names && v >= 0;
+            for (int i = 0; named && i <= v; i++)
+                named = plist->names[i];
+            if (named)
+                report(1, "  %-12s%-12s | %s", plist->name, plist->names[v],
+                       plist->summary);
+            else
+                report(1, "  %-12s%-12d | %s", plist->name, v,
+                       plist->summary);
             plist = plist->next;
         }
         return true;
@@ -311,32 +348,29 @@ static bool do_option(int argc, char *argv[])
     for (int i = 1; i < argc; i++) {
         char *name = argv[i];
         int value = 0;
-        bool found = false;
-        /* Get value from next argument */
-        if (i + 1 >= argc) {
-            report(1, "No value given for parameter %s", name);
-            return false;
-        } else if (!get_int(argv[++i], &value)) {
-            report(1, "Cannot parse '%s' as integer", argv[i]);
-            return false;
-        }
         /* Find parameter in list */
         param_element_t *plist = param_list;
-        while (!found && plist) {
-            if (strcmp(plist->name, name) == 0) {
-                int oldval = *plist->valp;
-                *plist->valp = value;
-                if (plist->setter)
-                    plist->setter(oldval);
-                found = true;
-            } else
-                plist = plist->next;
-        }
+        while (plist && strcmp(plist->name, name))
+            plist = plist->next;
         /* Didn't find parameter */
-        if (!found) {
+        if (!plist) {
             report(1, "Unknown parameter '%s'", name);
             return false;
         }
+        /* Get value from next argument */
+        if (i + 1 >= argc) {
+            report(1, "No value given for parameter %s", name);
+            return false;
+        } else if (!get_param_value(plist, argv[++i], &value)) {
+            report(1, plist->names ? "'%s' is not a value of %s"
+                                   : "Cannot parse '%s' as integer",
+                   argv[i], plist->name);
+            return false;
+        }
+        int oldval = *plist->valp;
+        *plist->valp = value;
+        if (plist->setter)
+            plist->setter(oldval);
     }
 
     return true;
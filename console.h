@@ -37,6 +37,8 @@ typedef struct __param_element {
     char *summary;
     /* Function that gets called whenever parameter changes */
     setter_func_t setter;
+    /* Optional names of the values 0, 1, ..., terminated by NULL */
+    char *const *names;
     struct __param_element *next;
 } param_element_t;
 
@@ -50,6 +52,15 @@ void add_cmd(char *name, cmd_func_t operation, char *summary, char *parameter);
 /* Add a new parameter */
 void add_param(char *name, int *valp, char *summary, setter_func_t setter);
 
+/* Add a new parameter whose values 0, 1, ... may also be given by the names
+ * in the NULL-terminated array names
+ */
+void add_named_param(char *name,
+                     int *valp,
+                     char *const *names,
+                     char *summary,
+                     setter_func_t setter);
+
 /* Extract integer from text and store at loc */
 bool get_int(char *vname, int *loc);
 
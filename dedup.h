@@ -0,0 +1,22 @@
+#ifndef LAB0_DEDUP_H
+#define LAB0_DEDUP_H
+
+#include <stdbool.h>
+
+#include "list.h"
+
+/**
+ * q_delete_dup_hash() - Delete all nodes whose string occurs more than once,
+ *                       whether or not the queue is sorted.
+ * @head: header of queue
+ *
+ * Unlike q_delete_dup(), duplicates need not be adjacent. The remaining nodes
+ * keep their order. Duplicates are found in a single pass with an
+ * open-addressing hash set, so this runs in O(n) but allocates the set.
+ *
+ * Return: true for success, false if list is NULL or the set could not be
+ * allocated.
+ */
+bool q_delete_dup_hash(struct list_head *head);
+
+#endif
@@ -4,6 +4,7 @@
 
 #include "constant.h"
 #include "cpucycles.h"
+#include "element.h"
 #include "queue.h"
 #include "random.h"
 
@@ -122,7 +123,7 @@ bool measure(int64_t *before_ticks,
             after_ticks[i] = cpucycles();
             int after_size = q_size(l);
             if (e)
-                q_release_element(e);
+                release_element(e);
             dut_free();
             if (before_size != after_size + 1)
                 return false;
@@ -140,7 +141,7 @@ bool measure(int64_t *before_ticks,
             after_ticks[i] = cpucycles();
             int after_size = q_size(l);
             if (e)
-                q_release_element(e);
+                release_element(e);
             dut_free();
             if (before_size != after_size + 1)
                 return false;
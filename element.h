@@ -0,0 +1,69 @@
+#ifndef LAB0_ELEMENT_H
+#define LAB0_ELEMENT_H
+
+#include <stdbool.h>
+
+#include "queue.h"
+
+/* Helpers of the list based queue that the other queue backends share, so
+ * that their elements are interchangeable with its own.
+ */
+
+/**
+ * new_element() - Allocate an element holding a copy of @s
+ * @node: receives the new element
+ * @s: string to copy
+ *
+ * The element comes from the slab pool when pool mode is on.
+ *
+ * Return: false for success, true if allocation failed.
+ */
+bool new_element(element_t **node, char *s);
+
+/**
+ * release_element() - Release an element of any of the queues
+ * @e: element to release
+ *
+ * Elements may share a slab, a bulk block or an interned string with others,
+ * so only this function knows how to give their storage back. The
+ * q_release_element() of queue.h assumes two separate blocks and must not be
+ * used on them.
+ */
+void release_element(element_t *e);
+
+/**
+ * new_malloc_element() - Allocate an element holding a copy of @s
+ * @node: receives the new element
+ * @s: string to copy
+ *
+ * The element has the same layout as those of the list based queue and is
+ * released with release_element(), but it never comes from the slab pool,
+ * which is not thread-safe. Queues shared between threads use this.
+ *
+ * Return: false for success, true if allocation failed.
+ */
+bool new_malloc_element(element_t **node, char *s);
+
+/**
+ * merge() - Merge two sorted NULL-terminated lists of elements
+ * @l1: first list, linked through element_t.list.next
+ * @l2: second list
+ * @descend: whether the lists are in descending order
+ *
+ * Return: the merged list, NULL-terminated. Only next pointers are set.
+ */
+struct list_head *merge(struct list_head *l1,
+                        struct list_head *l2,
+                        bool descend);
+
+/**
+ * q_mergeSort() - Sort a NULL-terminated list of @n elements
+ * @head: first node, linked through element_t.list.next
+ * @n: number of nodes
+ * @descend: whether to sort in descending order
+ *
+ * Return: the sorted list, NULL-terminated. Only next pointers are set.
+ */
+struct list_head *q_mergeSort(struct list_head *head, size_t n, bool descend);
+
+#endif /* LAB0_ELEMENT_H */
@@ -0,0 +1,174 @@
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "guard.h"
+#include "report.h"
+
+/* Address space reserved for guarded blocks. It is mapped PROT_NONE and
+ * without swap reservation, so only pages of live blocks cost memory.
+ */
+#define GUARD_REGION_SIZE (16UL << 30)
+
+/* Blocks spanning more data pages than this are not guarded */
+#define GUARD_MAX_PAGES 16
+
+/* A freed slot is reused only once this many slots of its size are queued */
+#define GUARD_QUARANTINE 64
+
+/* Mappings left to the rest of the process */
+#define GUARD_MAP_RESERVE 8192
+
+/**
+ * slot_queue_t - FIFO of released slots spanning the same number of pages
+ * @slots: ring buffer of slot addresses
+ * @head: index of the oldest slot
+ * @count: number of queued slots
+ * @cap: capacity of @slots
+ */
+typedef struct {
+    char **slots;
+    size_t head, count, cap;
+} slot_queue_t;
+
+static pthread_mutex_t guard_lock = PTHREAD_MUTEX_INITIALIZER;
+static char *region, *region_end, *region_next;
+static bool region_failed = false;
+static size_t page_size;
+static size_t live_blocks, max_live_blocks;
+static bool budget_warned = false;
+static slot_queue_t queues[GUARD_MAX_PAGES + 1];
+
+/* Live blocks allowed by vm.max_map_count. A block in a PROT_NONE area splits
+ * it, adding two mappings.
+ */
+static size_t map_budget()
+{
+    long max_maps = 65530;
+    FILE *f = fopen("/proc/sys/vm/max_map_count", "r");
+    if (f) {
+        if (fscanf(f, "%ld", &max_maps) != 1)
+            max_maps = 65530;
+        fclose(f);
+    }
+    return max_maps > GUARD_MAP_RESERVE ? (max_maps - GUARD_MAP_RESERVE) / 2
+                                        : 0;
+}
+
+static bool region_init()
+{
+    if (region)
+        return true;
+    if (region_failed)
+        return false;
+
+    page_size = sysconf(_SC_PAGESIZE);
+    void *p = mmap(NULL, GUARD_REGION_SIZE, PROT_NONE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (p == MAP_FAILED) {
+        report_event(MSG_WARN, "Couldn't reserve guard region, guard mode off");
+        region_failed = true;
+        return false;
+    }
+    region = region_next = p;
+    region_end = region + GUARD_REGION_SIZE;
+    max_live_blocks = map_budget();
+    return true;
+}
+
+static size_t data_pages(size_t hdr, size_t size)
+{
+    return (hdr + size + guard_slack(size) + page_size - 1) / page_size;
+}
+
+static char *queue_pop(slot_queue_t *q)
+{
+    if (q->count <= GUARD_QUARANTINE)
+        return NULL;
+    char *slot = q->slots[q->head];
+    q->head = (q->head + 1) % q->cap;
+    q->count--;
+    return slot;
+}
+
+static bool queue_push(slot_queue_t *q, char *slot)
+{
+    if (q->count == q->cap) {
+        size_t cap = q->cap ? 2 * q->cap : 2 * GUARD_QUARANTINE;
+        char **slots = malloc(cap * sizeof(*slots));
+        if (!slots)
+            return false;
+        for (size_t i = 0; i < q->count; i++)
+            slots[i] = q->slots[(q->head + i) % q->cap];
+        free(q->slots);
+        q->slots = slots;
+        q->head = 0;
+        q->cap = cap;
+    }
+    q->slots[(q->head + q->count++) % q->cap] = slot;
+    return true;
+}
+
+void *guard_alloc(size_t hdr, size_t size)
+{
+    pthread_mutex_lock(&guard_lock);
+    if (!region_init())
+        goto fail;
+
+    size_t pages = data_pages(hdr, size);
+    if (pages > GUARD_MAX_PAGES)
+        goto fail;
+    if (live_blocks >= max_live_blocks) {
+        if (!budget_warned)
+            report_event(MSG_WARN,
+                         "Guard mode mapping budget of %zu blocks used up, "
+                         "further blocks are unguarded",
+                         max_live_blocks);
+        budget_warned = true;
+        goto fail;
+    }
+
+    /* Slots are data pages followed by their own guard page */
+    char *slot = queue_pop(&queues[pages]);
+    if (!slot) {
+        if ((size_t) (region_end - region_next) < (pages + 1) * page_size)
+            goto fail;
+        slot = region_next;
+        region_next += (pages + 1) * page_size;
+    }
+    if (mprotect(slot, pages * page_size, PROT_READ | PROT_WRITE)) {
+        queue_push(&queues[pages], slot);
+        goto fail;
+    }
+    live_blocks++;
+    pthread_mutex_unlock(&guard_lock);
+
+    return slot + pages * page_size - guard_slack(size) - size - hdr;
+
+fail:
+    pthread_mutex_unlock(&guard_lock);
+    return NULL;
+}
+
+bool guard_owns(const void *block)
+{
+    const char *p = block;
+    return region && p >= region && p < region_next;
+}
+
+void guard_release(void *block, size_t hdr, size_t size)
+{
+    size_t pages = data_pages(hdr, size);
+    uintptr_t end = (uintptr_t) block + hdr + size + guard_slack(size);
+    char *slot = (char *) (end - pages * page_size);
+
+    pthread_mutex_lock(&guard_lock);
+    mprotect(slot, pages * page_size, PROT_NONE);
+    live_blocks--;
+    /* A slot that can't be queued is simply never reused */
+    queue_push(&queues[pages], slot);
+    pthread_mutex_unlock(&guard_lock);
+}
@@ -0,0 +1,58 @@
+#ifndef LAB0_GUARD_H
+#define LAB0_GUARD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Guard-page allocator used by the harness in guard mode.
+ *
+ * Every block is placed so that its payload ends right before a PROT_NONE
+ * page, which makes an overrun fault at the offending store instead of being
+ * found when the block is freed. Freed blocks are made inaccessible as well
+ * and are reused in FIFO order, so that stale pointers keep faulting for a
+ * while. Pages come from a single region reserved up front rather than from
+ * one mmap per block.
+ *
+ * Each live block costs the kernel its own memory mapping, and those are
+ * limited by vm.max_map_count. Once the limit is close, guard_alloc() returns
+ * NULL and callers fall back to ordinary blocks.
+ */
+
+/* Payloads are padded to this alignment; the padding is checked on release */
+#define GUARD_ALIGN 16
+
+/**
+ * guard_slack() - Padding between a payload and its guard page
+ * @size: payload size in bytes
+ */
+static inline size_t guard_slack(size_t size)
+{
+    return -size & (GUARD_ALIGN - 1);
+}
+
+/**
+ * guard_alloc() - Map a block whose payload ends at a guard page
+ * @hdr: bytes in front of the payload
+ * @size: payload size in bytes
+ *
+ * Return: start of the @hdr + @size byte block, followed by guard_slack(@size)
+ * bytes of padding. NULL if the block is too large for guard mode, the region
+ * is exhausted, or the mapping budget is used up.
+ */
+void *guard_alloc(size_t hdr, size_t size);
+
+/**
+ * guard_owns() - Whether @block was returned by guard_alloc()
+ * @block: any address
+ */
+bool guard_owns(const void *block);
+
+/**
+ * guard_release() - Make a block inaccessible and queue it for reuse
+ * @block: block returned by guard_alloc()
+ * @hdr: the same value passed to guard_alloc()
+ * @size: the same value passed to guard_alloc()
+ */
+void guard_release(void *block, size_t hdr, size_t size);
+
+#endif /* LAB0_GUARD_H */
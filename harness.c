@@ -1,18 +1,31 @@
 /* Test support code */
 
+#include <pthread.h>
+#include <sched.h>
 #include <setjmp.h>
 #include <signal.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
 #include <unistd.h>
 
+#include "guard.h"
 #include "report.h"
 
 /* Our program needs to use regular malloc/free */
 #define INTERNAL 1
 #include "harness.h"
 
+/* Older C libraries only expose the target thread of SIGEV_THREAD_ID through
+ * the union member
+ */
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
 /** Special values **/
 
 /* Value at start of every allocated block */
@@ -29,42 +42,347 @@
 
 /* Data structures used by our code */
 
-/* Represent allocated blocks as doubly-linked list, with
- * next and prev pointers at beginning
- */
+/* Header placed in front of every allocated block */
 typedef struct __block_element {
-    struct __block_element *next, *prev;
     size_t payload_size;
+    uint64_t birth; /* Value of alloc_seq when the block was allocated */
+    uint32_t site;    /* Index of the allocating call site in sites[] */
+    uint16_t arena;   /* Index of the owning arena in arenas[] */
+    uint16_t guarded; /* Placed by guard_alloc(), without footer */
     size_t magic_header; /* Marker to see if block seems legitimate */
     unsigned char payload[0];
     /* Also place magic number at tail of every block */
 } block_element_t;
 
-static block_element_t *allocated = NULL;
+/* Allocation statistics reported by memstat. Blocks are grouped into size
+ * classes by the power of two their size rounds up to, and lifetimes are
+ * measured in allocations made between a block's malloc and its free, which
+ * keeps the bookkeeping free of clock reads.
+ */
+#define SIZE_CLASSES 32
+#define LIFETIME_BUCKETS 64
+
+/* Call sites are interned in a fixed table; any beyond it share the last slot
+ */
+#define MAX_SITES 256
+#define SITE_SLOTS 512
+
+typedef struct {
+    size_t allocs; /* Number of allocations */
+    size_t bytes;  /* Payload bytes requested */
+    size_t live;   /* Blocks currently allocated */
+    size_t peak;   /* Maximum of live */
+} alloc_stat_t;
+
+typedef struct {
+    const char *file;
+    int line;
+    bool fail; /* Allocations from here fail while fault injection is on */
+} alloc_site_t;
+
+/* Sites are only ever added, under sites_lock, and a slot is published after
+ * its entry is filled in so that lookups can run without the lock.
+ */
+static alloc_site_t sites[MAX_SITES];
+static uint16_t site_slots[SITE_SLOTS]; /* Index into sites[] plus one */
+static size_t nsites = 0;
+static pthread_mutex_t sites_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Every thread allocates from its own arena, which holds the registry of the
+ * blocks it handed out and its share of the statistics. The registry is an
+ * open-addressing hash table keyed on the block address, so that validating
+ * a free costs O(1) instead of a walk over every live block. Slots are NULL
+ * when empty and the table is kept at most half full.
+ *
+ * Blocks remember their arena, and a free from another thread takes that
+ * arena's lock, so blocks may be passed between threads. Arenas outlive their
+ * threads; past MAX_ARENAS threads share them.
+ */
+#define TABLE_MIN_SIZE 1024
+#define MAX_ARENAS 256
+
+typedef struct {
+    pthread_mutex_t lock;
+    block_element_t **table;
+    size_t table_size;
+    size_t count;
+    uint64_t alloc_seq;
+    alloc_stat_t class_stats[SIZE_CLASSES];
+    size_t lifetimes[LIFETIME_BUCKETS];
+    alloc_stat_t site_stats[MAX_SITES];
+
+    /* Fault injection state, restarted when generation is stale */
+    uint64_t fault_generation;
+    uint64_t fault_calls;
+    uint64_t fault_bytes;
+    uint64_t rng_state;
+} arena_t;
+
+static arena_t *arenas[MAX_ARENAS];
+static uint32_t narenas = 0;
+static __thread arena_t *thread_arena;
+static __thread uint32_t thread_arena_id;
+
 static size_t allocated_count = 0;
 
+/* Fault injection. Every mode is off by default, and fault_armed caches
+ * whether any of them is on so that test_malloc pays a single branch
+ * otherwise. Changing a setting restarts the counters and reseeds the
+ * generator from fail_seed, which makes failures repeatable. Counters and
+ * generator are kept per arena, i.e. per thread.
+ */
+
 /* Percent probability of malloc failure */
 int fail_probability = 0;
 
-static bool cautious_mode = true;
-static bool noallocate_mode = false;
+/* Fail every fail_every-th allocation */
+int fail_every = 0;
+
+/* Fail allocations once fail_after bytes have been handed out */
+int fail_after = 0;
+
+/* Seed of the generator behind fail_probability */
+int fail_seed = 1;
+
+#define MAX_FAIL_SITES 16
+
+static struct {
+    char file[64];
+    int line;
+} fail_sites[MAX_FAIL_SITES];
+static int nfail_sites = 0;
+
+static bool fault_armed = false;
+static uint64_t fault_threshold; /* fail_probability scaled to 2^64 */
+static uint64_t fault_generation = 1;
+
+/* Guard every guard_mode-th block with an inaccessible page, 0 to disable */
+int guard_mode = 0;
+static uint64_t guard_seq = 0;
+
+/* Set by the main thread, read by every thread that allocates */
+static _Atomic bool cautious_mode = true;
+static _Atomic bool noallocate_mode = false;
 static bool error_occurred = false;
-static char *error_message = "";
 
-static int time_limit = 1;
+/* Seconds a risky operation may run before it is aborted */
+int time_limit = 1;
 
-/* Data for managing exceptions */
-static jmp_buf env;
-static volatile sig_atomic_t jmp_ready = false;
-static bool time_limited = false;
+/* Data for managing exceptions. Each thread has its own context, and its
+ * time limit is enforced by a timer that signals that thread alone.
+ */
+static __thread sigjmp_buf env;
+static __thread volatile sig_atomic_t jmp_ready = false;
+static __thread bool time_limited = false;
+static __thread char *error_message = "";
+static __thread timer_t limit_timer;
+static __thread bool limit_timer_made = false;
 
 /* Internal functions */
 
-/* Should this allocation fail? */
-static bool fail_allocation()
+static inline void flag_error()
+{
+    __atomic_store_n(&error_occurred, true, __ATOMIC_RELAXED);
+}
+
+/* Arena of the calling thread, created on its first allocation */
+static arena_t *get_arena()
+{
+    if (thread_arena)
+        return thread_arena;
+
+    uint32_t id = __atomic_fetch_add(&narenas, 1, __ATOMIC_RELAXED);
+    if (id < MAX_ARENAS) {
+        arena_t *a = calloc(1, sizeof(arena_t));
+        if (!a) {
+            report_event(MSG_FATAL, "Couldn't allocate any more memory");
+            return NULL;
+        }
+        pthread_mutex_init(&a->lock, NULL);
+        __atomic_store_n(&arenas[id], a, __ATOMIC_RELEASE);
+    } else {
+        id %= MAX_ARENAS;
+        while (!__atomic_load_n(&arenas[id], __ATOMIC_ACQUIRE))
+            sched_yield();
+    }
+    thread_arena_id = id;
+    thread_arena = arenas[id];
+    return thread_arena;
+}
+
+/* SplitMix64, used both to derive seeds and as the generator itself */
+static inline uint64_t splitmix64(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/* Should this allocation of size bytes from site fail?
+ * Called with the lock of arena a held.
+ */
+static bool fail_allocation(arena_t *a, uint32_t id, size_t size, uint32_t site)
+{
+    uint64_t generation = __atomic_load_n(&fault_generation, __ATOMIC_ACQUIRE);
+    if (a->fault_generation != generation) {
+        a->fault_generation = generation;
+        a->fault_calls = a->fault_bytes = 0;
+        a->rng_state = ((uint64_t) (uint32_t) fail_seed << 32) | (id + 1);
+    }
+
+    a->fault_calls++;
+    if (fail_every > 0 && a->fault_calls % fail_every == 0)
+        return true;
+    if (fail_after > 0 && a->fault_bytes + size > (size_t) fail_after)
+        return true;
+    if (sites[site].fail)
+        return true;
+    if (fault_threshold && splitmix64(&a->rng_state) < fault_threshold)
+        return true;
+
+    a->fault_bytes += size;
+    return false;
+}
+
+/* Home slot of block b in a table of size slots */
+static inline size_t table_slot(const block_element_t *b, size_t size)
 {
-    double weight = (double) random() / RAND_MAX;
-    return (weight < 0.01 * fail_probability);
+    uint64_t h = (uintptr_t) b >> 4;
+    h *= 0x9e3779b97f4a7c15ULL;
+    return (h >> 32) & (size - 1);
+}
+
+/* Index of the slot holding b, or a->table_size if it is not registered */
+static size_t table_find(const arena_t *a, const block_element_t *b)
+{
+    if (!a->table_size)
+        return 0;
+    size_t mask = a->table_size - 1;
+    for (size_t i = table_slot(b, a->table_size);; i = (i + 1) & mask) {
+        if (a->table[i] == b)
+            return i;
+        if (!a->table[i])
+            return a->table_size;
+    }
+}
+
+static void table_put(block_element_t **table, size_t size, block_element_t *b)
+{
+    size_t i = table_slot(b, size);
+    while (table[i])
+        i = (i + 1) & (size - 1);
+    table[i] = b;
+}
+
+/* Make room for one more block, doubling the table when it gets half full */
+static bool table_reserve(arena_t *a)
+{
+    if (2 * (a->count + 1) <= a->table_size)
+        return true;
+
+    size_t size = a->table_size ? 2 * a->table_size : TABLE_MIN_SIZE;
+    block_element_t **table = calloc(size, sizeof(*table));
+    if (!table)
+        return false;
+    for (size_t i = 0; i < a->table_size; i++) {
+        if (a->table[i])
+            table_put(table, size, a->table[i]);
+    }
+    free(a->table);
+    a->table = table;
+    a->table_size = size;
+    return true;
+}
+
+/* Empty slot i, shifting back later entries of its probe sequence so that
+ * lookups never need tombstones
+ */
+static void table_remove(arena_t *a, size_t i)
+{
+    size_t mask = a->table_size - 1;
+    size_t j = i;
+    for (;;) {
+        j = (j + 1) & mask;
+        if (!a->table[j])
+            break;
+        size_t k = table_slot(a->table[j], a->table_size);
+        /* Entry j may move to i only if its home slot is not in (i, j] */
+        if ((j > i && (k <= i || k > j)) || (j < i && k <= i && k > j)) {
+            a->table[i] = a->table[j];
+            i = j;
+        }
+    }
+    a->table[i] = NULL;
+}
+
+/* Number of bits needed for x, i.e. the power of two it rounds up to */
+static inline unsigned ceil_log2(uint64_t x)
+{
+    return x > 1 ? 64 - __builtin_clzll(x - 1) : 0;
+}
+
+static inline unsigned size_class(size_t size)
+{
+    unsigned c = ceil_log2(size);
+    return c < SIZE_CLASSES ? c : SIZE_CLASSES - 1;
+}
+
+static inline unsigned lifetime_bucket(uint64_t allocs)
+{
+    unsigned c = ceil_log2(allocs);
+    return c < LIFETIME_BUCKETS ? c : LIFETIME_BUCKETS - 1;
+}
+
+/* Probe for file:line, returning the slot holding it or the empty slot
+ * where it belongs
+ */
+static size_t site_probe(const char *file, int line)
+{
+    size_t i = (((uintptr_t) file >> 3) * 31 + line) & (SITE_SLOTS - 1);
+    for (;; i = (i + 1) & (SITE_SLOTS - 1)) {
+        uint16_t s = __atomic_load_n(&site_slots[i], __ATOMIC_ACQUIRE);
+        if (!s || (sites[s - 1].line == line && sites[s - 1].file == file))
+            return i;
+    }
+}
+
+/* Index of the call site file:line, registering it on first use */
+static uint32_t site_index(const char *file, int line)
+{
+    size_t i = site_probe(file, line);
+    uint16_t s = __atomic_load_n(&site_slots[i], __ATOMIC_ACQUIRE);
+    if (s)
+        return s - 1;
+
+    pthread_mutex_lock(&sites_lock);
+    i = site_probe(file, line);
+    if ((s = site_slots[i])) {
+        pthread_mutex_unlock(&sites_lock);
+        return s - 1;
+    }
+    if (nsites == MAX_SITES) {
+        pthread_mutex_unlock(&sites_lock);
+        return MAX_SITES - 1;
+    }
+
+    sites[nsites].file = nsites == MAX_SITES - 1 ? "(other)" : file;
+    sites[nsites].line = nsites == MAX_SITES - 1 ? 0 : line;
+    for (int f = 0; f < nfail_sites; f++) {
+        if (fail_sites[f].line == line && !strcmp(fail_sites[f].file, file))
+            sites[nsites].fail = true;
+    }
+    __atomic_store_n(&site_slots[i], ++nsites, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&sites_lock);
+    return nsites - 1;
+}
+
+static inline void stat_alloc(alloc_stat_t *stat, size_t size)
+{
+    stat->allocs++;
+    stat->bytes += size;
+    if (++stat->live > stat->peak)
+        stat->peak = stat->live;
 }
 
 /* Find header of block, given its payload.
@@ -74,38 +392,33 @@ static block_element_t *find_header(void *p)
 {
     if (!p) {
         report_event(MSG_ERROR, "Attempting to free null block");
-        error_occurred = true;
+        flag_error();
     }
 
     block_element_t *b =
         (block_element_t *) ((size_t) p - sizeof(block_element_t));
-    if (cautious_mode) {
-        /* Make sure this is really an allocated block */
-        block_element_t *ab = allocated;
-        bool found = false;
-        while (ab && !found) {
-            found = ab == b;
-            ab = ab->next;
-        }
-        if (!found) {
-            report_event(MSG_ERROR,
-                         "Attempted to free unallocated block.  Address = %p",
-                         p);
-            error_occurred = true;
-        }
-    }
-
     if (b->magic_header != MAGICHEADER) {
         report_event(
             MSG_ERROR,
             "Attempted to free unallocated or corrupted block.  Address = %p",
             p);
-        error_occurred = true;
+        flag_error();
     }
 
     return b;
 }
 
+/* Is the padding between a guarded payload and its guard page untouched? */
+static bool slack_intact(const block_element_t *b)
+{
+    const unsigned char *slack = b->payload + b->payload_size;
+    for (size_t i = 0; i < guard_slack(b->payload_size); i++) {
+        if (slack[i] != FILLCHAR)
+            return false;
+    }
+    return true;
+}
+
 /* Given pointer to block, find its footer */
 static size_t *find_footer(block_element_t *b)
 {
@@ -118,40 +431,61 @@ static size_t *find_footer(block_element_t *b)
 /* Implementation of application functions */
 
 void *test_malloc(size_t size)
+{
+    return test_malloc_at(size, "(unknown)", 0);
+}
+
+void *test_malloc_at(size_t size, const char *file, int line)
 {
     if (noallocate_mode) {
         report_event(MSG_FATAL, "Calls to malloc disallowed");
         return NULL;
     }
 
-    if (fail_allocation()) {
+    arena_t *a = get_arena();
+    uint32_t site = site_index(file, line);
+    pthread_mutex_lock(&a->lock);
+    if (fault_armed && fail_allocation(a, thread_arena_id, size, site)) {
+        pthread_mutex_unlock(&a->lock);
         report_event(MSG_WARN, "Malloc returning NULL");
         return NULL;
     }
 
-    block_element_t *new_block =
-        malloc(size + sizeof(block_element_t) + sizeof(size_t));
-    if (!new_block) {
+    block_element_t *new_block = NULL;
+    if (guard_mode > 0 &&
+        __atomic_fetch_add(&guard_seq, 1, __ATOMIC_RELAXED) % guard_mode == 0)
+        new_block = guard_alloc(sizeof(block_element_t), size);
+    bool guarded = new_block;
+    if (!guarded)
+        new_block = malloc(size + sizeof(block_element_t) + sizeof(size_t));
+    if (!new_block || !table_reserve(a)) {
+        pthread_mutex_unlock(&a->lock);
         report_event(MSG_FATAL, "Couldn't allocate any more memory");
-        error_occurred = true;
+        flag_error();
     }
 
     // cppcheck-suppress nullPointerRedundantCheck
     new_block->magic_header = MAGICHEADER;
     // cppcheck-suppress nullPointerRedundantCheck
     new_block->payload_size = size;
-    *find_footer(new_block) = MAGICFOOTER;
+    new_block->guarded = guarded;
     void *p = (void *) &new_block->payload;
-    memset(p, FILLCHAR, size);
-    // cppcheck-suppress nullPointerRedundantCheck
-    new_block->next = allocated;
-    // cppcheck-suppress nullPointerRedundantCheck
-    new_block->prev = NULL;
+    if (guarded) {
+        memset(p, FILLCHAR, size + guard_slack(size));
+    } else {
+        *find_footer(new_block) = MAGICFOOTER;
+        memset(p, FILLCHAR, size);
+    }
 
-    if (allocated)
-        allocated->prev = new_block;
-    allocated = new_block;
-    allocated_count++;
+    new_block->birth = a->alloc_seq++;
+    new_block->site = site;
+    new_block->arena = thread_arena_id;
+    table_put(a->table, a->table_size, new_block);
+    a->count++;
+    stat_alloc(&a->class_stats[size_class(size)], size);
+    stat_alloc(&a->site_stats[site], size);
+    pthread_mutex_unlock(&a->lock);
+    __atomic_fetch_add(&allocated_count, 1, __ATOMIC_RELAXED);
 
     return p;
 }
@@ -179,37 +513,61 @@ void test_free(void *p)
         return;
 
     block_element_t *b = find_header(p);
-    size_t footer = *find_footer(b);
-    if (footer != MAGICFOOTER) {
+    bool guarded = b->guarded && guard_owns(b);
+    if (guarded ? !slack_intact(b) : *find_footer(b) != MAGICFOOTER) {
         report_event(MSG_ERROR,
                      "Corruption detected in block with address %p when "
                      "attempting to free it",
                      p);
-        error_occurred = true;
+        flag_error();
     }
-    b->magic_header = MAGICFREE;
-    *find_footer(b) = MAGICFREE;
-    memset(p, FILLCHAR, b->payload_size);
 
-    /* Unlink from list */
-    block_element_t *bn = b->next;
-    block_element_t *bp = b->prev;
-    if (bp)
-        bp->next = bn;
-    else
-        allocated = bn;
-    if (bn)
-        bn->prev = bp;
+    /* Drop from the registry of the arena it came from */
+    arena_t *a = b->arena < MAX_ARENAS
+                     ? __atomic_load_n(&arenas[b->arena], __ATOMIC_ACQUIRE)
+                     : NULL;
+    bool found = false;
+    if (a) {
+        pthread_mutex_lock(&a->lock);
+        size_t i = table_find(a, b);
+        if (i != a->table_size) {
+            found = true;
+            table_remove(a, i);
+            a->count--;
+            a->class_stats[size_class(b->payload_size)].live--;
+            a->site_stats[b->site].live--;
+            a->lifetimes[lifetime_bucket(a->alloc_seq - b->birth)]++;
+        }
+        pthread_mutex_unlock(&a->lock);
+    }
+    if (!found && cautious_mode) {
+        /* Make sure this is really an allocated block */
+        report_event(MSG_ERROR,
+                     "Attempted to free unallocated block.  Address = %p", p);
+        flag_error();
+    }
 
-    free(b);
-    allocated_count--;
+    b->magic_header = MAGICFREE;
+    memset(p, FILLCHAR, b->payload_size);
+    if (guarded) {
+        guard_release(b, sizeof(block_element_t), b->payload_size);
+    } else {
+        *find_footer(b) = MAGICFREE;
+        free(b);
+    }
+    __atomic_fetch_sub(&allocated_count, 1, __ATOMIC_RELAXED);
 }
 
 // cppcheck-suppress unusedFunction
 char *test_strdup(const char *s)
+{
+    return test_strdup_at(s, "(unknown)", 0);
+}
+
+char *test_strdup_at(const char *s, const char *file, int line)
 {
     size_t len = strlen(s) + 1;
-    void *new = test_malloc(len);
+    void *new = test_malloc_at(len, file, line);
     if (!new)
         return NULL;
 
@@ -218,11 +576,161 @@ char *test_strdup(const char *s)
 
 size_t allocation_check()
 {
-    return allocated_count;
+    return __atomic_load_n(&allocated_count, __ATOMIC_RELAXED);
 }
 
 /* Implementation of functions for testing */
 
+void fault_update(int oldval)
+{
+    int p = fail_probability < 0 ? 0 : fail_probability;
+    fault_threshold = p >= 100 ? UINT64_MAX : (UINT64_MAX / 100) * p;
+    fault_armed = fault_threshold || fail_every > 0 || fail_after > 0 ||
+                  nfail_sites > 0;
+    __atomic_add_fetch(&fault_generation, 1, __ATOMIC_RELEASE);
+}
+
+bool fault_add_site(const char *file, int line)
+{
+    if (nfail_sites == MAX_FAIL_SITES ||
+        strlen(file) >= sizeof(fail_sites[0].file))
+        return false;
+
+    pthread_mutex_lock(&sites_lock);
+    strcpy(fail_sites[nfail_sites].file, file);
+    fail_sites[nfail_sites++].line = line;
+    for (size_t i = 0; i < nsites; i++) {
+        if (sites[i].line == line && !strcmp(sites[i].file, file))
+            sites[i].fail = true;
+    }
+    pthread_mutex_unlock(&sites_lock);
+    fault_update(0);
+    return true;
+}
+
+void fault_clear_sites()
+{
+    pthread_mutex_lock(&sites_lock);
+    nfail_sites = 0;
+    for (size_t i = 0; i < nsites; i++)
+        sites[i].fail = false;
+    pthread_mutex_unlock(&sites_lock);
+    fault_update(0);
+}
+
+/* Statistics summed over all arenas. With several threads the peaks are the
+ * sum of the per-thread peaks, an upper bound of the real one.
+ */
+typedef struct {
+    alloc_stat_t class_stats[SIZE_CLASSES];
+    size_t lifetimes[LIFETIME_BUCKETS];
+    alloc_stat_t site_stats[MAX_SITES];
+} memstat_t;
+
+static void stat_add(alloc_stat_t *sum, const alloc_stat_t *st)
+{
+    sum->allocs += st->allocs;
+    sum->bytes += st->bytes;
+    sum->live += st->live;
+    sum->peak += st->peak;
+}
+
+static void memstat_collect(memstat_t *m)
+{
+    memset(m, 0, sizeof(*m));
+    uint32_t n = __atomic_load_n(&narenas, __ATOMIC_RELAXED);
+    for (uint32_t id = 0; id < n && id < MAX_ARENAS; id++) {
+        arena_t *a = __atomic_load_n(&arenas[id], __ATOMIC_ACQUIRE);
+        if (!a)
+            continue;
+        pthread_mutex_lock(&a->lock);
+        for (int c = 0; c < SIZE_CLASSES; c++)
+            stat_add(&m->class_stats[c], &a->class_stats[c]);
+        for (int c = 0; c < LIFETIME_BUCKETS; c++)
+            m->lifetimes[c] += a->lifetimes[c];
+        for (int s = 0; s < MAX_SITES; s++)
+            stat_add(&m->site_stats[s], &a->site_stats[s]);
+        pthread_mutex_unlock(&a->lock);
+    }
+}
+
+static const alloc_stat_t *sort_stats;
+
+static int site_cmp(const void *a, const void *b)
+{
+    const alloc_stat_t *sa = &sort_stats[*(const uint32_t *) a];
+    const alloc_stat_t *sb = &sort_stats[*(const uint32_t *) b];
+    if (sa->bytes != sb->bytes)
+        return sa->bytes < sb->bytes ? 1 : -1;
+    if (sa->allocs != sb->allocs)
+        return sa->allocs < sb->allocs ? 1 : -1;
+    return 0;
+}
+
+void memstat_report()
+{
+    static memstat_t m;
+    memstat_collect(&m);
+
+    report(1, "%-12s %12s %14s %10s %10s", "Size class", "Allocs", "Bytes",
+           "Live", "Peak");
+    for (int c = 0; c < SIZE_CLASSES; c++) {
+        const alloc_stat_t *st = &m.class_stats[c];
+        if (!st->allocs)
+            continue;
+        report(1, "<= %-9zu %12zu %14zu %10zu %10zu", (size_t) 1 << c,
+               st->allocs, st->bytes, st->live, st->peak);
+    }
+
+    report(1, "%-12s %12s", "Lifetime", "Frees");
+    for (int c = 0; c < LIFETIME_BUCKETS; c++) {
+        if (m.lifetimes[c])
+            report(1, "<= %-9llu %12zu", 1ULL << c, m.lifetimes[c]);
+    }
+
+    uint32_t order[MAX_SITES];
+    size_t n = __atomic_load_n(&nsites, __ATOMIC_RELAXED);
+    for (size_t i = 0; i < n; i++)
+        order[i] = i;
+    sort_stats = m.site_stats;
+    qsort(order, n, sizeof(*order), site_cmp);
+    report(1, "%-24s %12s %14s %10s %10s", "Call site", "Allocs", "Bytes",
+           "Live", "Peak");
+    for (size_t i = 0; i < n; i++) {
+        const alloc_stat_t *st = &m.site_stats[order[i]];
+        if (!st->allocs)
+            continue;
+        char where[64];
+        snprintf(where, sizeof(where), "%s:%d", sites[order[i]].file,
+                 sites[order[i]].line);
+        report(1, "%-24s %12zu %14zu %10zu %10zu", where, st->allocs,
+               st->bytes, st->live, st->peak);
+    }
+}
+
+static void stat_reset(alloc_stat_t *st)
+{
+    st->allocs = st->bytes = 0;
+    st->peak = st->live;
+}
+
+void memstat_reset()
+{
+    uint32_t n = __atomic_load_n(&narenas, __ATOMIC_RELAXED);
+    for (uint32_t id = 0; id < n && id < MAX_ARENAS; id++) {
+        arena_t *a = __atomic_load_n(&arenas[id], __ATOMIC_ACQUIRE);
+        if (!a)
+            continue;
+        pthread_mutex_lock(&a->lock);
+        for (int c = 0; c < SIZE_CLASSES; c++)
+            stat_reset(&a->class_stats[c]);
+        memset(a->lifetimes, 0, sizeof(a->lifetimes));
+        for (int s = 0; s < MAX_SITES; s++)
+            stat_reset(&a->site_stats[s]);
+        pthread_mutex_unlock(&a->lock);
+    }
+}
+
 /* Set/unset cautious mode.
  * In this mode, makes extra sure any block to be freed is currently allocated.
  */
@@ -242,9 +750,27 @@ void set_noallocate_mode(bool noallocate)
 /* Return whether any errors have occurred since last time set error limit */
 bool error_check()
 {
-    bool e = error_occurred;
-    error_occurred = false;
-    return e;
+    return __atomic_exchange_n(&error_occurred, false, __ATOMIC_RELAXED);
+}
+
+/* Arm or disarm the time limit of the calling thread */
+static void set_limit_timer(int seconds)
+{
+    if (!limit_timer_made) {
+        struct sigevent sev = {
+            .sigev_notify = SIGEV_THREAD_ID,
+            .sigev_signo = SIGALRM,
+        };
+        sev.sigev_notify_thread_id = syscall(SYS_gettid);
+        if (timer_create(CLOCK_MONOTONIC, &sev, &limit_timer)) {
+            report_event(MSG_WARN, "Couldn't create a time limit timer");
+            return;
+        }
+        limit_timer_made = true;
+    }
+
+    struct itimerspec spec = {.it_value = {.tv_sec = seconds}};
+    timer_settime(limit_timer, 0, &spec, NULL);
 }
 
 /* Prepare for a risky operation using setjmp.
@@ -256,7 +782,7 @@ bool exception_setup(bool limit_time)
         /* Got here from longjmp */
         jmp_ready = false;
         if (time_limited) {
-            alarm(0);
+            set_limit_timer(0);
             time_limited = false;
         }
 
@@ -269,7 +795,7 @@ bool exception_setup(bool limit_time)
     /* Got here from initial call */
     jmp_ready = true;
     if (limit_time) {
-        alarm(time_limit);
+        set_limit_timer(time_limit);
         time_limited = true;
     }
     return true;
@@ -279,7 +805,7 @@ bool exception_setup(bool limit_time)
 void exception_cancel()
 {
     if (time_limited) {
-        alarm(0);
+        set_limit_timer(0);
         time_limited = false;
     }
 
@@ -290,7 +816,7 @@ void exception_cancel()
 /* Use longjmp to return to most recent exception setup */
 void trigger_exception(char *msg)
 {
-    error_occurred = true;
+    flag_error();
     error_message = msg;
     if (jmp_ready)
         siglongjmp(env, 1);
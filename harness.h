@@ -14,6 +14,12 @@ void *test_malloc(size_t size);
 void *test_calloc(size_t nmemb, size_t size);
 void test_free(void *p);
 char *test_strdup(const char *s);
+
+/* Variants of test_malloc and test_strdup that attribute the block to the
+ * call site file:line in the statistics shown by memstat_report()
+ */
+void *test_malloc_at(size_t size, const char *file, int line);
+char *test_strdup_at(const char *s, const char *file, int line);
 /* FIXME: provide test_realloc as well */
 
 #ifdef INTERNAL
@@ -21,9 +27,45 @@ char *test_strdup(const char *s);
 /* Report number of allocated blocks */
 size_t allocation_check();
 
+/* Print allocation counts, bytes, live and peak blocks per size class and
+ * per call site, plus a histogram of block lifetimes counted in allocations
+ */
+void memstat_report();
+
+/* Clear the counters of memstat_report(), keeping track of live blocks */
+void memstat_reset();
+
 /* Probability of malloc failing, expressed as percent */
 extern int fail_probability;
 
+/* Fail every Nth malloc, 0 to disable */
+extern int fail_every;
+
+/* Fail mallocs once this many bytes have been allocated, 0 to disable */
+extern int fail_after;
+
+/* Seed of the generator deciding failures by fail_probability */
+extern int fail_seed;
+
+/* Apply changed fault injection settings and restart their counters.
+ * Has the signature of a console parameter setter.
+ */
+void fault_update(int oldval);
+
+/* Make every malloc at file:line fail. Return false if the list is full */
+bool fault_add_site(const char *file, int line);
+
+/* Empty the list of failing call sites */
+void fault_clear_sites();
+
+/* Place every Nth block against an inaccessible page, so that overruns fault
+ * immediately. 0 disables guard mode.
+ */
+extern int guard_mode;
+
+/* Seconds before an operation guarded by exception_setup() is aborted */
+extern int time_limit;
+
 /*
  * Set/unset cautious mode.
  * In this mode, makes extra sure any block to be freed is currently allocated.
@@ -54,12 +96,12 @@ void trigger_exception(char *msg);
 #else /* !INTERNAL */
 
 /* Tested program use our versions of malloc and free */
-#define malloc test_malloc
+#define malloc(size) test_malloc_at(size, __FILE__, __LINE__)
 #define free test_free
 
 /* Use undef to avoid strdup redefined error */
 #undef strdup
-#define strdup test_strdup
+#define strdup(s) test_strdup_at(s, __FILE__, __LINE__)
 
 #endif
 
@@ -0,0 +1,201 @@
+#include <stdint.h>
+
+#include "index.h"
+#include "pool.h"
+
+/**
+ * struct qindex_node - Tree node of an index
+ * @left: nodes before this one
+ * @right: nodes after this one
+ * @size: number of nodes in this subtree
+ * @node: the list node at this position
+ */
+struct qindex_node {
+    struct qindex_node *left, *right;
+    int size;
+    struct list_head *node;
+};
+
+typedef struct qindex_node tnode_t;
+
+/* Tree nodes of all indexes, carved from slabs */
+static pool_t tnode_pool = POOL_INIT(tnode_pool, sizeof(tnode_t), 256);
+
+/* xorshift64*, private so that indexing never disturbs other random streams */
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+
+static inline uint64_t rng_next()
+{
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 0x2545F4914F6CDD1DULL;
+}
+
+static inline int tsize(const tnode_t *t)
+{
+    return t ? t->size : 0;
+}
+
+static inline void update(tnode_t *t)
+{
+    t->size = 1 + tsize(t->left) + tsize(t->right);
+}
+
+static void tree_free(tnode_t *t)
+{
+    while (t) {
+        tree_free(t->left);
+        tnode_t *right = t->right;
+        pool_free(t);
+        t = right;
+    }
+}
+
+/* Split t into its first k nodes and the rest */
+static void split(tnode_t *t, int k, tnode_t **a, tnode_t **b)
+{
+    if (!t) {
+        *a = *b = NULL;
+    } else if (k <= tsize(t->left)) {
+        split(t->left, k, a, &t->left);
+        update(t);
+        *b = t;
+    } else {
+        split(t->right, k - tsize(t->left) - 1, &t->right, b);
+        update(t);
+        *a = t;
+    }
+}
+
+/* Concatenate a and b, the root coming from each in proportion to its size */
+static tnode_t *join(tnode_t *a, tnode_t *b)
+{
+    if (!a || !b)
+        return a ? a : b;
+    if (rng_next() % (uint64_t) (a->size + b->size) < (uint64_t) a->size) {
+        a->right = join(a->right, b);
+        update(a);
+        return a;
+    }
+    b->left = join(a, b->left);
+    update(b);
+    return b;
+}
+
+static tnode_t *insert_at(tnode_t *t, int i, tnode_t *x)
+{
+    if (rng_next() % (uint64_t) (tsize(t) + 1) == 0) {
+        split(t, i, &x->left, &x->right);
+        update(x);
+        return x;
+    }
+    if (i <= tsize(t->left))
+        t->left = insert_at(t->left, i, x);
+    else
+        t->right = insert_at(t->right, i - tsize(t->left) - 1, x);
+    update(t);
+    return t;
+}
+
+static tnode_t *remove_at(tnode_t *t, int i, tnode_t **out)
+{
+    int l = tsize(t->left);
+    if (i == l) {
+        *out = t;
+        return join(t->left, t->right);
+    }
+    if (i < l)
+        t->left = remove_at(t->left, i, out);
+    else
+        t->right = remove_at(t->right, i - l - 1, out);
+    update(t);
+    return t;
+}
+
+/* Perfectly balanced tree over the next n list nodes from *cur. On failure
+ * the nodes built so far are freed and *ok is cleared.
+ */
+static tnode_t *build(struct list_head **cur, int n, bool *ok)
+{
+    if (!n || !*ok)
+        return NULL;
+
+    tnode_t *left = build(cur, n / 2, ok);
+    tnode_t *t = *ok ? pool_alloc(&tnode_pool) : NULL;
+    if (!t) {
+        tree_free(left);
+        *ok = false;
+        return NULL;
+    }
+    t->left = left;
+    t->node = *cur;
+    *cur = (*cur)->next;
+    t->right = build(cur, n - n / 2 - 1, ok);
+    if (!*ok) {
+        t->right = NULL;
+        tree_free(t);
+        return NULL;
+    }
+    update(t);
+    return t;
+}
+
+void qindex_init(qindex_t *ix)
+{
+    ix->root = NULL;
+    ix->valid = false;
+}
+
+void qindex_clear(qindex_t *ix)
+{
+    tree_free(ix->root);
+    qindex_init(ix);
+}
+
+bool qindex_build(qindex_t *ix, struct list_head *head, int n)
+{
+    qindex_clear(ix);
+    struct list_head *cur = head->next;
+    bool ok = true;
+    ix->root = build(&cur, n, &ok);
+    ix->valid = ok;
+    return ok;
+}
+
+struct list_head *qindex_get(const qindex_t *ix, int i)
+{
+    const tnode_t *t = ix->root;
+    for (;;) {
+        int l = tsize(t->left);
+        if (i == l)
+            return t->node;
+        if (i < l) {
+            t = t->left;
+        } else {
+            i -= l + 1;
+            t = t->right;
+        }
+    }
+}
+
+void qindex_insert(qindex_t *ix, int i, struct list_head *node)
+{
+    tnode_t *x = pool_alloc(&tnode_pool);
+    if (!x) {
+        qindex_clear(ix);
+        return;
+    }
+    x->left = x->right = NULL;
+    x->node = node;
+    ix->root = insert_at(ix->root, i, x);
+}
+
+struct list_head *qindex_delete(qindex_t *ix, int i)
+{
+    tnode_t *out;
+    ix->root = remove_at(ix->root, i, &out);
+    struct list_head *node = out->node;
+    pool_free(out);
+    return node;
+}
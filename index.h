@@ -0,0 +1,116 @@
+#ifndef LAB0_INDEX_H
+#define LAB0_INDEX_H
+
+#include <stdbool.h>
+
+#include "list.h"
+#include "queue.h"
+
+/* Order-statistic index over the nodes of a list.
+ *
+ * The index is an implicit treap: a binary tree whose in-order traversal
+ * visits the list nodes in list order and where every tree node records the
+ * size of its subtree, so the i-th node is found by descending from the root
+ * in O(log n). No keys or priorities are stored. Instead, the tree is kept
+ * balanced in expectation by the randomized BST rules, which make a new node
+ * the root of a subtree of size s with probability 1/(s + 1).
+ *
+ * Queues keep one index each while index mode is on. Inserting or removing at
+ * a known position updates it in O(log n); operations that reorder the whole
+ * queue only mark it stale, which neither allocates nor frees, and it is
+ * rebuilt in O(n) the next time it is needed.
+ */
+
+struct qindex_node;
+
+/**
+ * qindex_t - Index of one list
+ * @root: root of the tree, may hold stale nodes while @valid is false
+ * @valid: whether the tree matches the list
+ */
+typedef struct {
+    struct qindex_node *root;
+    bool valid;
+} qindex_t;
+
+/* Queues index themselves while this is set */
+extern int index_mode;
+
+/* Start with an empty, invalid index */
+void qindex_init(qindex_t *ix);
+
+/* Free the tree and mark the index invalid */
+void qindex_clear(qindex_t *ix);
+
+/* Mark the index stale without touching the tree */
+static inline void qindex_invalidate(qindex_t *ix)
+{
+    ix->valid = false;
+}
+
+/**
+ * qindex_build() - Index the @n nodes of a list from scratch
+ * @ix: the index, its old tree is freed first
+ * @head: head of the list
+ * @n: number of nodes in the list
+ *
+ * Return: true for success, false if out of memory, leaving @ix invalid.
+ */
+bool qindex_build(qindex_t *ix, struct list_head *head, int n);
+
+/* List node at position @i of a valid index, 0 <= @i < size */
+struct list_head *qindex_get(const qindex_t *ix, int i);
+
+/**
+ * qindex_insert() - Record that @node was inserted at position @i
+ * @ix: a valid index
+ * @i: position of @node, 0 <= @i <= old size
+ * @node: the new list node
+ *
+ * If no tree node can be allocated the index is cleared instead.
+ */
+void qindex_insert(qindex_t *ix, int i, struct list_head *node);
+
+/* Drop position @i of a valid index and return the list node it held */
+struct list_head *qindex_delete(qindex_t *ix, int i);
+
+/**
+ * q_index_update() - Bring the index of a queue in line with index mode
+ * @head: header of queue
+ *
+ * Builds the index of the queue while index mode is on, so that cheap
+ * mutators keep it up to date from then on, and frees it while the mode is
+ * off. Failing to build it is not an error, it is tried again when needed.
+ */
+void q_index_update(struct list_head *head);
+
+/**
+ * q_get() - Element at position @i of the queue
+ * @head: header of queue
+ * @i: position, counting from 0
+ *
+ * Return: the element, NULL if @head is NULL or there is no position @i.
+ */
+element_t *q_get(struct list_head *head, int i);
+
+/**
+ * q_insert_at() - Insert a copy of string @s at position @i
+ * @head: header of queue
+ * @i: position of the new element, 0 <= @i <= size
+ * @s: string to copy
+ *
+ * Return: true for success, false if @head is NULL, @i is out of range or
+ * allocation failed.
+ */
+bool q_insert_at(struct list_head *head, int i, char *s);
+
+/**
+ * q_delete_at() - Delete the element at position @i
+ * @head: header of queue
+ * @i: position, counting from 0
+ *
+ * Return: true for success, false if @head is NULL or there is no position @i.
+ */
+bool q_delete_at(struct list_head *head, int i);
+
+#endif /* LAB0_INDEX_H */
@@ -0,0 +1,125 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "intern.h"
+
+/* Strings and buckets are regular test_malloc blocks */
+#include "harness.h"
+
+/**
+ * intern_entry_t - A shared string
+ * @next: next entry in the same bucket
+ * @hash: hash of @str
+ * @refs: number of references handed out by intern_get()
+ * @str: the string
+ */
+typedef struct intern_entry {
+    struct intern_entry *next;
+    uint64_t hash;
+    size_t refs;
+    char str[];
+} intern_entry_t;
+
+/* Buckets of the first table allocated */
+#define INTERN_MIN_BUCKETS 64
+
+int intern_mode = 0;
+
+/* Chained hash table, NULL while it holds no strings */
+static intern_entry_t **buckets;
+static size_t nbuckets, nentries;
+
+/* FNV-1a, 64-bit */
+static inline uint64_t intern_hash(const char *s, size_t len)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (unsigned char) s[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+/* Move every entry to a table of n buckets, keeping the old one if the new
+ * one cannot be allocated.
+ */
+static void rehash(size_t n)
+{
+    intern_entry_t **nb = malloc(n * sizeof(*nb));
+    if (!nb)
+        return;
+    memset(nb, 0, n * sizeof(*nb));
+    for (size_t i = 0; i < nbuckets; i++) {
+        for (intern_entry_t *e = buckets[i], *next; e; e = next) {
+            next = e->next;
+            e->next = nb[e->hash & (n - 1)];
+            nb[e->hash & (n - 1)] = e;
+        }
+    }
+    free(buckets);
+    buckets = nb;
+    nbuckets = n;
+}
+
+char *intern_get(const char *s, size_t len)
+{
+    uint64_t h = intern_hash(s, len);
+    if (buckets) {
+        for (intern_entry_t *e = buckets[h & (nbuckets - 1)]; e; e = e->next) {
+            if (e->hash == h && !memcmp(e->str, s, len)) {
+                e->refs++;
+                return e->str;
+            }
+        }
+    }
+
+    if (!buckets)
+        rehash(INTERN_MIN_BUCKETS);
+    else if (nentries >= nbuckets)
+        rehash(2 * nbuckets);
+    if (!buckets)
+        return NULL;
+
+    intern_entry_t *e = malloc(sizeof(intern_entry_t) + len);
+    if (!e) {
+        if (!nentries) {
+            free(buckets);
+            buckets = NULL;
+            nbuckets = 0;
+        }
+        return NULL;
+    }
+    memcpy(e->str, s, len);
+    e->hash = h;
+    e->refs = 1;
+    e->next = buckets[h & (nbuckets - 1)];
+    buckets[h & (nbuckets - 1)] = e;
+    nentries++;
+    return e->str;
+}
+
+void intern_put(char *s)
+{
+    intern_entry_t *e = (intern_entry_t *) (s - offsetof(intern_entry_t, str));
+    if (--e->refs)
+        return;
+
+    intern_entry_t **pp = &buckets[e->hash & (nbuckets - 1)];
+    while (*pp != e)
+        pp = &(*pp)->next;
+    *pp = e->next;
+    free(e);
+
+    if (!--nentries) {
+        free(buckets);
+        buckets = NULL;
+        nbuckets = 0;
+    }
+}
+
+size_t intern_count()
+{
+    return nentries;
+}
@@ -0,0 +1,43 @@
+#ifndef LAB0_INTERN_H
+#define LAB0_INTERN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Reference-counted table of shared strings.
+ *
+ * While intern mode is on, elements do not own a copy of their string but
+ * a reference to the single copy kept here, so equal values share storage
+ * and two interned values are equal exactly when they are the same pointer.
+ * A string is freed with its last reference, and the table itself once it
+ * holds no strings, so the table never outlives the elements using it.
+ *
+ * The table is not thread-safe. Elements shared between threads are never
+ * interned.
+ */
+
+/* Elements created by new_element() are interned while this is set */
+extern int intern_mode;
+
+/**
+ * intern_get() - Take a reference to the shared copy of a string
+ * @s: the string
+ * @len: length of @s, terminator included
+ *
+ * Return: the shared copy, added to the table if it is not there yet, NULL
+ * if it had to be added and allocation failed.
+ */
+char *intern_get(const char *s, size_t len);
+
+/**
+ * intern_put() - Drop a reference taken by intern_get()
+ * @s: the shared copy
+ *
+ * The copy is removed from the table and freed with its last reference.
+ */
+void intern_put(char *s);
+
+/* Number of distinct strings in the table */
+size_t intern_count();
+
+#endif /* LAB0_INTERN_H */
@@ -0,0 +1,62 @@
+#ifndef LAB0_LIST_PREFETCH_H
+#define LAB0_LIST_PREFETCH_H
+
+#include "list.h"
+
+/* Traversal of long lists with software prefetching.
+ *
+ * Walking a list scattered over the heap is a chain of dependent loads, each
+ * of which may miss the cache. The macros below behave like their list.h
+ * counterparts, but request the node after the next one as soon as the next
+ * node is known, so that its miss overlaps the work done on the current node
+ * instead of stalling the following iteration.
+ *
+ * Prefetching only pays off where something other than the next link waits
+ * on memory: the strings compared or freed along the walk, or the node after
+ * the next one. A bare walk such as q_reverse() needs each node right after
+ * the previous one, so there is nothing left to overlap.
+ *
+ * Build with -DLIST_PREFETCH=0 (make PREFETCH=0) to turn every prefetch into
+ * a no-op and compare. While it is off, list_prefetch() does not evaluate its
+ * argument.
+ */
+
+#ifndef LIST_PREFETCH
+#define LIST_PREFETCH 1
+#endif
+
+#if LIST_PREFETCH
+#define list_prefetch(addr) __builtin_prefetch(addr)
+#else
+#define list_prefetch(addr) ((void) 0)
+#endif
+
+/**
+ * list_for_each_prefetch - Iterate over list nodes, prefetching ahead
+ * @node: list_head pointer used as iterator
+ * @head: pointer to the head of the list
+ *
+ * The nodes must not be removed while iterating.
+ */
+#define list_for_each_prefetch(node, head)                       \
+    for (node = (head)->next;                                    \
+         node != (head) && (list_prefetch(node->next->next), 1); \
+         node = node->next)
+
+/**
+ * list_for_each_entry_safe_prefetch - Iterate over entries, prefetching ahead
+ * @entry: pointer used as iterator
+ * @safe: @type pointer used to store info for next entry in list
+ * @head: pointer to the head of the list
+ * @member: name of the list_head member variable in struct type of @entry
+ *
+ * The current entry may be removed from the list while iterating.
+ */
+#define list_for_each_entry_safe_prefetch(entry, safe, head, member)        \
+    for (entry = list_entry((head)->next, __typeof__(*entry), member),      \
+        safe = list_entry(entry->member.next, __typeof__(*entry), member);  \
+         &entry->member != (head) && (list_prefetch(safe->member.next), 1); \
+         entry = safe,                                                      \
+        safe = list_entry(safe->member.next, __typeof__(*entry), member))
+
+#endif /* LAB0_LIST_PREFETCH_H */
@@ -3,6 +3,7 @@
 #define _LINUX_LIST_SORT_H
 
 #include <linux/types.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 #define likely(x) __builtin_expect(!!(x), 1)
@@ -15,4 +16,5 @@ typedef uint8_t u8;
 
 void list_sort(struct list_head *head);
 void timsort(struct list_head *head);
+void radixsort(struct list_head *head, bool descend);
 #endif
\ No newline at end of file
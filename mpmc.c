@@ -0,0 +1,274 @@
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "element.h"
+#include "mpmc.h"
+
+/* Threads that may use mpmc queues at the same time */
+#define MPMC_MAX_THREADS 64
+
+/* Hazard pointers each thread needs: the head and its successor */
+#define MPMC_HAZARDS 2
+
+/* Retired nodes are scanned once this many are pending. It exceeds the number
+ * of hazard pointers, so every scan frees at least half of them.
+ */
+#define MPMC_RETIRE_MAX (2 * MPMC_MAX_THREADS * MPMC_HAZARDS)
+
+/* Blocks from malloc are not aligned to cache lines, so members written by
+ * different threads are kept apart by a whole line of padding instead.
+ */
+#define CACHE_LINE 64
+
+typedef struct mpmc_node {
+    struct mpmc_node *next;
+    element_t *e;
+} mpmc_node_t;
+
+struct mpmc {
+    char pad0[CACHE_LINE];
+    mpmc_node_t *head;
+    char pad1[CACHE_LINE];
+    mpmc_node_t *tail;
+    char pad2[CACHE_LINE];
+    size_t size;
+    char pad3[CACHE_LINE];
+};
+
+/**
+ * hazard_rec_t - Hazard pointers and retired nodes of one thread
+ * @hp: nodes the owning thread is about to dereference
+ * @active: whether a thread owns this record
+ * @retired: nodes unlinked by the owner and waiting to be freed
+ * @nretired: number of entries in @retired
+ * @pad: keeps the hazard pointers of the next record off this one's lines
+ *
+ * Records are statically allocated and claimed by threads on first use, so
+ * they never show up as leaked blocks. A record given up by an exiting thread
+ * keeps its retired nodes for the next owner.
+ */
+typedef struct {
+    mpmc_node_t *hp[MPMC_HAZARDS];
+    bool active;
+    mpmc_node_t *retired[MPMC_RETIRE_MAX];
+    size_t nretired;
+    char pad[CACHE_LINE];
+} hazard_rec_t;
+
+static hazard_rec_t records[MPMC_MAX_THREADS];
+static pthread_key_t record_key;
+static pthread_once_t record_once = PTHREAD_ONCE_INIT;
+static __thread hazard_rec_t *my_record;
+
+static void record_release(void *rec)
+{
+    hazard_rec_t *r = rec;
+    for (int i = 0; i < MPMC_HAZARDS; i++)
+        __atomic_store_n(&r->hp[i], NULL, __ATOMIC_RELEASE);
+    __atomic_store_n(&r->active, false, __ATOMIC_RELEASE);
+}
+
+static void record_key_init()
+{
+    pthread_key_create(&record_key, record_release);
+}
+
+/* Hazard record of the calling thread, claimed on first use */
+static hazard_rec_t *get_record()
+{
+    if (my_record)
+        return my_record;
+
+    pthread_once(&record_once, record_key_init);
+    for (;;) {
+        for (int i = 0; i < MPMC_MAX_THREADS; i++) {
+            bool idle = false;
+            if (__atomic_compare_exchange_n(&records[i].active, &idle, true,
+                                            false, __ATOMIC_ACQUIRE,
+                                            __ATOMIC_RELAXED)) {
+                my_record = &records[i];
+                pthread_setspecific(record_key, my_record);
+                return my_record;
+            }
+        }
+        /* All records in use, wait for a thread to exit */
+        sched_yield();
+    }
+}
+
+/* Publish *src in hazard pointer i and return it once it is stable */
+static mpmc_node_t *protect(hazard_rec_t *r, int i, mpmc_node_t **src)
+{
+    mpmc_node_t *p = __atomic_load_n(src, __ATOMIC_ACQUIRE);
+    for (;;) {
+        __atomic_store_n(&r->hp[i], p, __ATOMIC_SEQ_CST);
+        mpmc_node_t *q = __atomic_load_n(src, __ATOMIC_SEQ_CST);
+        if (q == p)
+            return p;
+        p = q;
+    }
+}
+
+static bool is_hazard(mpmc_node_t *const *hazards, size_t n, mpmc_node_t *p)
+{
+    for (size_t i = 0; i < n; i++) {
+        if (hazards[i] == p)
+            return true;
+    }
+    return false;
+}
+
+/* Free the retired nodes of r that no thread has published */
+static void scan(hazard_rec_t *r)
+{
+    mpmc_node_t *hazards[MPMC_MAX_THREADS * MPMC_HAZARDS];
+    size_t n = 0;
+    for (int t = 0; t < MPMC_MAX_THREADS; t++) {
+        for (int i = 0; i < MPMC_HAZARDS; i++) {
+            mpmc_node_t *p =
+                __atomic_load_n(&records[t].hp[i], __ATOMIC_SEQ_CST);
+            if (p)
+                hazards[n++] = p;
+        }
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < r->nretired; i++) {
+        if (is_hazard(hazards, n, r->retired[i]))
+            r->retired[kept++] = r->retired[i];
+        else
+            free(r->retired[i]);
+    }
+    r->nretired = kept;
+}
+
+static void retire(hazard_rec_t *r, mpmc_node_t *node)
+{
+    r->retired[r->nretired++] = node;
+    if (r->nretired == MPMC_RETIRE_MAX)
+        scan(r);
+}
+
+mpmc_t *mpmc_new()
+{
+    mpmc_t *q = malloc(sizeof(mpmc_t));
+    mpmc_node_t *dummy = malloc(sizeof(mpmc_node_t));
+    if (!q || !dummy) {
+        free(q);
+        free(dummy);
+        return NULL;
+    }
+
+    dummy->next = NULL;
+    dummy->e = NULL;
+    q->head = q->tail = dummy;
+    q->size = 0;
+    return q;
+}
+
+void mpmc_free(mpmc_t *q)
+{
+    if (q) {
+        element_t *e;
+        while ((e = mpmc_remove_head(q, NULL, 0)))
+            release_element(e);
+        free(q->head);
+        free(q);
+    }
+
+    /* Quiescent, so nothing retired can still be referenced */
+    for (int t = 0; t < MPMC_MAX_THREADS; t++) {
+        for (size_t i = 0; i < records[t].nretired; i++)
+            free(records[t].retired[i]);
+        records[t].nretired = 0;
+    }
+}
+
+bool mpmc_insert_tail(mpmc_t *q, char *s)
+{
+    if (!q)
+        return false;
+
+    mpmc_node_t *node = malloc(sizeof(mpmc_node_t));
+    if (!node)
+        return false;
+    if (new_malloc_element(&node->e, s)) {
+        free(node);
+        return false;
+    }
+    node->next = NULL;
+
+    hazard_rec_t *r = get_record();
+    for (;;) {
+        mpmc_node_t *tail = protect(r, 0, &q->tail);
+        mpmc_node_t *next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+        if (tail != __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE))
+            continue;
+        if (next) {
+            /* Help a producer that linked its node but not moved tail yet */
+            __atomic_compare_exchange_n(&q->tail, &tail, next, false,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+            continue;
+        }
+        if (__atomic_compare_exchange_n(&tail->next, &next, node, false,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+            __atomic_compare_exchange_n(&q->tail, &tail, node, false,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+            break;
+        }
+    }
+    __atomic_store_n(&r->hp[0], NULL, __ATOMIC_RELEASE);
+    __atomic_fetch_add(&q->size, 1, __ATOMIC_RELAXED);
+    return true;
+}
+
+element_t *mpmc_remove_head(mpmc_t *q, char *sp, size_t bufsize)
+{
+    if (!q)
+        return NULL;
+
+    hazard_rec_t *r = get_record();
+    mpmc_node_t *head;
+    element_t *e;
+    for (;;) {
+        head = protect(r, 0, &q->head);
+        mpmc_node_t *tail = __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+        mpmc_node_t *next = protect(r, 1, &head->next);
+        if (head != __atomic_load_n(&q->head, __ATOMIC_ACQUIRE))
+            continue;
+        if (!next) {
+            e = NULL;
+            break;
+        }
+        if (head == tail) {
+            __atomic_compare_exchange_n(&q->tail, &tail, next, false,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+            continue;
+        }
+        /* next becomes the new dummy, its element is handed out */
+        e = next->e;
+        if (__atomic_compare_exchange_n(&q->head, &head, next, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+            break;
+    }
+    __atomic_store_n(&r->hp[0], NULL, __ATOMIC_RELEASE);
+    __atomic_store_n(&r->hp[1], NULL, __ATOMIC_RELEASE);
+    if (!e)
+        return NULL;
+
+    retire(r, head);
+    __atomic_fetch_sub(&q->size, 1, __ATOMIC_RELAXED);
+    if (sp) {
+        strncpy(sp, e->value, bufsize);
+        sp[bufsize - 1] = '\0';
+    }
+    return e;
+}
+
+size_t mpmc_size(mpmc_t *q)
+{
+    return q ? __atomic_load_n(&q->size, __ATOMIC_RELAXED) : 0;
+}
@@ -0,0 +1,72 @@
+#ifndef LAB0_MPMC_H
+#define LAB0_MPMC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "queue.h"
+
+/* Lock-free multi-producer/multi-consumer queue of element_t.
+ *
+ * This is the Michael-Scott queue: a singly linked list with a dummy node at
+ * the head, where producers append with a compare-and-swap on the last next
+ * pointer and consumers advance the head with a compare-and-swap. Unlinked
+ * nodes are reclaimed with hazard pointers, so a node is never freed while
+ * another thread may still read it.
+ *
+ * Elements are the same as those of the list based queue and are released
+ * with release_element(). They are always allocated with malloc, never from
+ * the slab pool, which is not thread-safe.
+ */
+
+typedef struct mpmc mpmc_t;
+
+/**
+ * mpmc_new() - Create an empty queue
+ *
+ * Return: the new queue, NULL if allocation failed.
+ */
+mpmc_t *mpmc_new();
+
+/**
+ * mpmc_free() - Free a queue together with the elements still in it
+ * @q: queue to free, may be NULL
+ *
+ * No other thread may use @q or any other mpmc queue concurrently, which lets
+ * this also reclaim every node retired so far.
+ */
+void mpmc_free(mpmc_t *q);
+
+/**
+ * mpmc_insert_tail() - Append a copy of string @s
+ * @q: the queue
+ * @s: string to copy
+ *
+ * Safe to call from any number of threads at once.
+ *
+ * Return: true for success, false if allocation failed.
+ */
+bool mpmc_insert_tail(mpmc_t *q, char *s);
+
+/**
+ * mpmc_remove_head() - Take the oldest element
+ * @q: the queue
+ * @sp: string would be inserted
+ * @bufsize: size of the string
+ *
+ * Safe to call from any number of threads at once. If @sp is non-NULL, the
+ * string is copied into it as q_remove_head() does.
+ *
+ * Return: the element, NULL if the queue was empty.
+ */
+element_t *mpmc_remove_head(mpmc_t *q, char *sp, size_t bufsize);
+
+/**
+ * mpmc_size() - Number of elements in the queue
+ * @q: the queue
+ *
+ * Exact only while no other thread modifies @q.
+ */
+size_t mpmc_size(mpmc_t *q);
+
+#endif /* LAB0_MPMC_H */
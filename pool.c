@@ -0,0 +1,112 @@
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "pool.h"
+
+/* Slabs are regular test_malloc blocks */
+#include "harness.h"
+
+/**
+ * pool_slab_t - A block holding several objects of the same pool
+ * @list: node in pool->partial while the slab has unused objects
+ * @pool: the pool this slab belongs to
+ * @free_objs: objects released back to this slab, chained through themselves
+ * @used: number of objects ever handed out by bumping
+ * @live: number of objects currently in use
+ * @objs: storage, each object preceded by a pointer back to its slab
+ */
+typedef struct pool_slab {
+    struct list_head list;
+    pool_t *pool;
+    void *free_objs;
+    size_t used;
+    size_t live;
+    void *objs[];
+} pool_slab_t;
+
+/* Per-object header, the slab can be found without searching */
+typedef struct {
+    pool_slab_t *slab;
+    void *obj[];
+} pool_obj_t;
+
+static inline size_t obj_stride(const pool_t *pool)
+{
+    size_t align = sizeof(void *);
+    return (sizeof(pool_obj_t) + pool->obj_size + align - 1) & ~(align - 1);
+}
+
+static inline bool slab_full(const pool_slab_t *slab)
+{
+    return !slab->free_objs && slab->used == slab->pool->slab_objs;
+}
+
+static pool_slab_t *slab_new(pool_t *pool)
+{
+    pool_slab_t *slab =
+        malloc(sizeof(pool_slab_t) + obj_stride(pool) * pool->slab_objs);
+    if (!slab)
+        return NULL;
+
+    slab->pool = pool;
+    slab->free_objs = NULL;
+    slab->used = slab->live = 0;
+    list_add(&slab->list, &pool->partial);
+    pool->nslabs++;
+    return slab;
+}
+
+void *pool_alloc(pool_t *pool)
+{
+    pool_slab_t *slab;
+    if (list_empty(&pool->partial)) {
+        slab = slab_new(pool);
+        if (!slab)
+            return NULL;
+    } else {
+        slab = list_first_entry(&pool->partial, pool_slab_t, list);
+    }
+
+    void *obj;
+    if (slab->free_objs) {
+        obj = slab->free_objs;
+        slab->free_objs = *(void **) obj;
+    } else {
+        pool_obj_t *o =
+            (pool_obj_t *) ((char *) slab->objs + obj_stride(pool) * slab->used);
+        o->slab = slab;
+        obj = o->obj;
+        slab->used++;
+    }
+    slab->live++;
+
+    if (slab_full(slab))
+        list_del_init(&slab->list);
+    return obj;
+}
+
+void pool_free(void *obj)
+{
+    if (!obj)
+        return;
+
+    pool_obj_t *o =
+        (pool_obj_t *) ((char *) obj - offsetof(pool_obj_t, obj));
+    pool_slab_t *slab = o->slab;
+    pool_t *pool = slab->pool;
+    bool was_full = slab_full(slab);
+
+    *(void **) obj = slab->free_objs;
+    slab->free_objs = obj;
+
+    if (--slab->live == 0) {
+        if (!was_full)
+            list_del(&slab->list);
+        pool->nslabs--;
+        free(slab);
+        return;
+    }
+
+    if (was_full)
+        list_add(&slab->list, &pool->partial);
+}
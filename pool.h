@@ -0,0 +1,54 @@
+#ifndef LAB0_POOL_H
+#define LAB0_POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "list.h"
+
+/* Slab allocator for fixed-size objects.
+ *
+ * Objects are carved out of slabs obtained from malloc, so every slab is a
+ * single block as far as the test harness is concerned. A slab is returned to
+ * malloc as soon as its last object is released, which keeps the allocation
+ * accounting exact: an empty pool holds no memory at all.
+ */
+
+/**
+ * pool_t - A pool of equally sized objects
+ * @obj_size: size of each object in bytes
+ * @slab_objs: number of objects carved from each slab
+ * @partial: slabs which still have at least one unused object
+ * @nslabs: number of slabs currently allocated
+ */
+typedef struct {
+    size_t obj_size;
+    size_t slab_objs;
+    struct list_head partial;
+    size_t nslabs;
+} pool_t;
+
+#define POOL_INIT(name, size, objs)                     \
+    {                                                   \
+        .obj_size = (size), .slab_objs = (objs),        \
+        .partial = {&(name).partial, &(name).partial}, \
+    }
+
+/**
+ * pool_alloc() - Take one object from the pool
+ * @pool: the pool to allocate from
+ *
+ * Return: pointer to uninitialized object, NULL if a new slab was needed and
+ * could not be allocated.
+ */
+void *pool_alloc(pool_t *pool);
+
+/**
+ * pool_free() - Give an object back to the pool it was allocated from
+ * @obj: object returned by pool_alloc()
+ *
+ * The slab holding @obj is freed once all of its objects are released.
+ */
+void pool_free(void *obj);
+
+#endif /* LAB0_POOL_H */
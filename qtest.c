@@ -3,6 +3,7 @@
 #include <assert.h>
 #include <errno.h>
 #include <getopt.h>
+#include <pthread.h>
 #include <signal.h>
 #include <spawn.h>
 #include <stdio.h>
@@ -21,10 +22,21 @@
 
 #include "dudect/fixture.h"
 #include "list.h"
+#include "mt19937-64.h"
 #include "random.h"
 /* Shannon entropy */
 extern double shannon_entropy(const uint8_t *input_data);
 extern int show_entropy;
+/* Slab allocation of queue elements */
+extern int pool_mode;
+/* Cached-key comparison in the sorts */
+extern int prefix_mode;
+/* Number of threads used by q_sort */
+extern int sort_threads;
+/* How q_merge combines queues */
+extern int merge_mode;
+/* Order-statistic index of queues */
+extern int index_mode;
 
 /* Our program needs to use regular malloc/free */
 #define INTERNAL 1
@@ -44,11 +56,19 @@ extern int show_entropy;
 #include "agents/mcts.h"
 #include "agents/negamax.h"
 #include "console.h"
+#include "bulk.h"
+#include "dedup.h"
+#include "element.h"
 #include "game.h"
+#include "index.h"
+#include "intern.h"
 #include "list_sort.h"
+#include "mpmc.h"
 #include "queue.h"
 #include "report.h"
+#include "ring.h"
 #include "shuffle.h"
+#include "unroll.h"
 #include "ttt_coro.h"
 /* Settable parameters */
 
@@ -56,7 +76,6 @@ extern int show_entropy;
 
 /* How large is a queue before it's considered big.
  * This affects how it gets printed
- * and whether cautious mode is used when freeing the queue
  */
 #define BIG_LIST_SIZE 30
 
@@ -78,6 +97,9 @@ static int string_length = MAXSTRING;
 
 static int descend = 0;
 static int ttt_mode = 0;
+
+/* Repeated insertions go through the bulk API while this is set */
+static int bulk_mode = 0;
 #define MIN_RANDSTR_LEN 5
 #define MAX_RANDSTR_LEN 10
 static const char charset[] = "abcdefghijklmnopqrstuvwxyz";
@@ -89,8 +111,479 @@ typedef enum {
 /* Forward declarations */
 static bool q_show(int vlevel);
 
+/* Which queue new, it, rh, size, show and free operate on */
+enum { BACKEND_LIST, BACKEND_RING, BACKEND_UNROLL };
+static int backend = BACKEND_LIST;
+static char *const backend_names[] = {"list", "ring", "unroll", NULL};
+
+/**
+ * queue_ops_t - Implementation of the queue.h API behind the queue commands
+ *
+ * The list and unrolled backends share the struct list_head handle, so both
+ * keep their queues in the chain and differ only in these functions.
+ */
+typedef struct {
+    struct list_head *(*new)(void);
+    void (*free)(struct list_head *head);
+    bool (*insert_head)(struct list_head *head, char *s);
+    bool (*insert_tail)(struct list_head *head, char *s);
+    element_t *(*remove_head)(struct list_head *head, char *sp, size_t n);
+    element_t *(*remove_tail)(struct list_head *head, char *sp, size_t n);
+    int (*size)(struct list_head *head);
+    bool (*delete_mid)(struct list_head *head);
+    bool (*delete_dup)(struct list_head *head);
+    void (*swap)(struct list_head *head);
+    void (*reverse)(struct list_head *head);
+    void (*reverseK)(struct list_head *head, int k);
+    void (*sort)(struct list_head *head, bool descend);
+    int (*ascend)(struct list_head *head);
+    int (*descend)(struct list_head *head);
+    int (*merge)(struct list_head *head, bool descend);
+} queue_ops_t;
+
+static const queue_ops_t list_ops = {
+    .new = q_new,
+    .free = q_free,
+    .insert_head = q_insert_head,
+    .insert_tail = q_insert_tail,
+    .remove_head = q_remove_head,
+    .remove_tail = q_remove_tail,
+    .size = q_size,
+    .delete_mid = q_delete_mid,
+    .delete_dup = q_delete_dup,
+    .swap = q_swap,
+    .reverse = q_reverse,
+    .reverseK = q_reverseK,
+    .sort = q_sort,
+    .ascend = q_ascend,
+    .descend = q_descend,
+    .merge = q_merge,
+};
+
+static const queue_ops_t unroll_ops = {
+    .new = unroll_new,
+    .free = unroll_free,
+    .insert_head = unroll_insert_head,
+    .insert_tail = unroll_insert_tail,
+    .remove_head = unroll_remove_head,
+    .remove_tail = unroll_remove_tail,
+    .size = unroll_size,
+    .delete_mid = unroll_delete_mid,
+    .delete_dup = unroll_delete_dup,
+    .swap = unroll_swap,
+    .reverse = unroll_reverse,
+    .reverseK = unroll_reverseK,
+    .sort = unroll_sort,
+    .ascend = unroll_ascend,
+    .descend = unroll_descend,
+    .merge = unroll_merge,
+};
+
+/* Backend of the queues in the chain, kept while the ring backend is used */
+static const queue_ops_t *qops = &list_ops;
+
+static void backend_update(int oldval)
+{
+    if (backend < BACKEND_LIST || backend > BACKEND_UNROLL) {
+        report(1, "ERROR: Unknown backend %d", backend);
+        backend = oldval;
+        return;
+    }
+    if (backend == BACKEND_RING)
+        return;
+
+    const queue_ops_t *ops =
+        backend == BACKEND_UNROLL ? &unroll_ops : &list_ops;
+    if (chain.size && ops != qops) {
+        report(1, "ERROR: Free all queues before switching to the %s backend",
+               backend_names[backend]);
+        backend = oldval;
+        return;
+    }
+    qops = ops;
+}
+
+/* Build or drop the index of every queue when the index option changes */
+static void index_update(int oldval)
+{
+    if (qops != &list_ops)
+        return;
+    queue_contex_t *ctx;
+    list_for_each_entry (ctx, &chain.head, chain)
+        q_index_update(ctx->q);
+}
+
+/* Reject commands that only the list backend implements */
+static bool list_backend_only(const char *cmd)
+{
+    if (qops == &list_ops)
+        return true;
+    report(1, "%s is not supported by the unroll backend", cmd);
+    return false;
+}
+
+/**
+ * queue_iter_t - Position in a queue of either the list or unroll backend
+ * @node: list node of the element, for the list backend
+ * @u: position of the element, for the unroll backend
+ */
+typedef struct {
+    struct list_head *node;
+    unroll_iter_t u;
+} queue_iter_t;
+
+static element_t *queue_first(struct list_head *q, queue_iter_t *it)
+{
+    if (qops == &unroll_ops)
+        return unroll_first(q, &it->u);
+    it->node = q->next;
+    return it->node == q ? NULL : list_entry(it->node, element_t, list);
+}
+
+static element_t *queue_next(struct list_head *q, queue_iter_t *it)
+{
+    if (qops == &unroll_ops)
+        return unroll_next(q, &it->u);
+    it->node = it->node->next;
+    return it->node == q ? NULL : list_entry(it->node, element_t, list);
+}
+
+static element_t *queue_last(struct list_head *q)
+{
+    if (qops == &unroll_ops)
+        return unroll_last(q);
+    return list_empty(q) ? NULL : list_last_entry(q, element_t, list);
+}
+
+/* Capacity of the rings created by new in the ring backend */
+static int ring_size_param = 1 << 20;
+
+static ring_t *ring = NULL;
+static int ring_count = 0;
+
+/* The lock-free queue used by the mp* commands */
+static mpmc_t *mpq = NULL;
+
+/* Check that no blocks are left once the last queue of any kind is gone. The
+ * ring and the mpmc queue own blocks of their own, so while either of them
+ * exists the blocks still allocated cannot be told apart from leaks.
+ */
+static bool leak_check()
+{
+    if (chain.size || ring || mpq)
+        return true;
+    size_t bcnt = allocation_check();
+    if (bcnt > 0) {
+        report(1,
+               "ERROR: There is no queue, but %zu blocks are still allocated",
+               bcnt);
+        return false;
+    }
+    return true;
+}
+
+static bool ring_show(int vlevel)
+{
+    if (verblevel < vlevel)
+        return true;
+    if (!ring) {
+        report(vlevel, "r = NULL");
+        return true;
+    }
+
+    report_noreturn(vlevel, "r = [");
+    element_t *e;
+    int cnt = 0;
+    for (; cnt < BIG_LIST_SIZE && (e = ring_at(ring, cnt)); cnt++)
+        report_noreturn(vlevel, cnt == 0 ? "%s" : " %s", e->value);
+    report(vlevel, ring_at(ring, cnt) ? " ... ]" : "]");
+    return true;
+}
+
+static bool ring_new_cmd(int argc, char *argv[])
+{
+    if (argc != 1) {
+        report(1, "%s takes no arguments", argv[0]);
+        return false;
+    }
+
+    ring_free(ring);
+    ring = ring_new(ring_size_param > 0 ? ring_size_param : 1);
+    ring_count = 0;
+    if (!ring)
+        report(1, "ERROR: Could not allocate ring");
+    ring_show(3);
+    return ring && !error_check();
+}
+
+static bool ring_free_cmd(int argc, char *argv[])
+{
+    if (argc != 1) {
+        report(1, "%s takes no arguments", argv[0]);
+        return false;
+    }
+    if (!ring)
+        report(3, "Warning: Calling free on null ring");
+
+    error_check();
+    if (exception_setup(true))
+        ring_free(ring);
+    exception_cancel();
+    ring = NULL;
+    ring_count = 0;
+    ring_show(3);
+
+    bool ok = leak_check();
+    return ok && !error_check();
+}
+
+/* Insert str n times with the batched enqueue */
+static bool ring_insert_cmd(int argc, char *argv[])
+{
+    int reps = 1;
+    if (argc != 2 && argc != 3) {
+        report(1, "%s needs 1-2 arguments", argv[0]);
+        return false;
+    }
+    if (argc == 3 && !get_int(argv[2], &reps)) {
+        report(1, "Invalid number of insertions '%s'", argv[2]);
+        return false;
+    }
+    if (!ring) {
+        report(3, "Warning: Calling insert tail on null ring");
+        return false;
+    }
+
+    size_t done = 0;
+    error_check();
+    if (exception_setup(true))
+        done = ring_insert_tail(ring, argv[1], reps);
+    exception_cancel();
+    ring_count += done;
+
+    bool ok = true;
+    if (done < (size_t) reps) {
+        fail_count++;
+        if (ring_size(ring) == ring_capacity(ring)) {
+            report(1, "ERROR: Ring full after %zu of %d insertions", done,
+                   reps);
+            ok = false;
+        } else if (fail_count < fail_limit) {
+            report(2, "Insertion of %s failed", argv[1]);
+        } else {
+            report(1, "ERROR: Insertion of %s failed (%d failures total)",
+                   argv[1], fail_count);
+            ok = false;
+        }
+    }
+    ring_show(3);
+    return ok && !error_check();
+}
+
+static bool ring_remove_cmd(int argc, char *argv[])
+{
+    if (argc != 1 && argc != 2) {
+        report(1, "%s needs 0-1 arguments", argv[0]);
+        return false;
+    }
+    if (!ring) {
+        report(3, "Warning: Calling remove head on null ring");
+        return false;
+    }
+
+    char removes[MAXSTRING + 1] = "";
+    element_t *re = NULL;
+    error_check();
+    if (exception_setup(true))
+        re = ring_remove_head(ring, removes, sizeof(removes));
+    exception_cancel();
+
+    bool ok = true;
+    if (!re) {
+        report(1, "ERROR: Removal from ring failed");
+        ok = false;
+    } else {
+        release_element(re);
+        ring_count--;
+        report(2, "Removed %s from ring", removes);
+        if (argc == 2 && strcmp(removes, argv[1])) {
+            report(1, "ERROR: Removed value %s != expected value %s",
+                   removes, argv[1]);
+            ok = false;
+        }
+    }
+    ring_show(3);
+    return ok && !error_check();
+}
+
+static bool ring_size_cmd(int argc, char *argv[])
+{
+    if (argc != 1) {
+        report(1, "%s takes no arguments", argv[0]);
+        return false;
+    }
+    if (!ring) {
+        report(3, "Warning: Calling size on null ring");
+        return true;
+    }
+
+    size_t cnt = ring_size(ring);
+    if (cnt != (size_t) ring_count) {
+        report(1, "ERROR: Computed ring size as %zu, but correct value is %d",
+               cnt, ring_count);
+        return false;
+    }
+    report(2, "Ring size = %zu", cnt);
+    return true;
+}
+
+/**
+ * ringbench_t - State shared by the two threads of ringbench
+ * @r: the ring under test
+ * @count: elements to pass through, lowered by the producer when it stops
+ * @batch: elements per enqueue_n/dequeue_n call
+ * @errors: elements out of order
+ * @alloc_failed: the producer stopped because an element could not be
+ *                allocated
+ */
+typedef struct {
+    ring_t *r;
+    int count;
+    int batch;
+    int errors;
+    bool alloc_failed;
+} ringbench_t;
+
+#define RINGBENCH_MAX_BATCH 256
+
+static void *ringbench_producer(void *arg)
+{
+    ringbench_t *b = arg;
+    element_t *es[RINGBENCH_MAX_BATCH];
+    char buf[16];
+    for (int i = 0; i < b->count;) {
+        int n = b->count - i < b->batch ? b->count - i : b->batch;
+        for (int k = 0; k < n; k++) {
+            snprintf(buf, sizeof(buf), "%d", i + k);
+            /* Injected malloc failures are retried */
+            int tries = 0;
+            while (new_malloc_element(&es[k], buf)) {
+                if (++tries == 1000)
+                    break;
+            }
+            if (tries == 1000) {
+                /* Stop here, the consumer stops after the last element */
+                while (k--)
+                    release_element(es[k]);
+                b->alloc_failed = true;
+                __atomic_store_n(&b->count, i, __ATOMIC_RELEASE);
+                return NULL;
+            }
+        }
+        for (int k = 0; k < n;) {
+            size_t put = ring_enqueue_n(b->r, es + k, n - k);
+            if (!put)
+                sched_yield();
+            k += put;
+        }
+        i += n;
+    }
+    return NULL;
+}
+
+static void *ringbench_consumer(void *arg)
+{
+    ringbench_t *b = arg;
+    element_t *es[RINGBENCH_MAX_BATCH];
+    for (int expect = 0;
+         expect < __atomic_load_n(&b->count, __ATOMIC_ACQUIRE);) {
+        size_t n = ring_dequeue_n(b->r, es, b->batch);
+        if (!n)
+            sched_yield();
+        for (size_t k = 0; k < n; k++, expect++) {
+            if (atoi(es[k]->value) != expect)
+                b->errors++;
+            release_element(es[k]);
+        }
+    }
+    return NULL;
+}
+
+static bool do_ringbench(int argc, char *argv[])
+{
+    int count = 1000000, batch = 32, capacity = 1024;
+    if (argc > 4 || (argc > 1 && !get_int(argv[1], &count)) ||
+        (argc > 2 && !get_int(argv[2], &batch)) ||
+        (argc > 3 && !get_int(argv[3], &capacity))) {
+        report(1, "%s takes [count] [batch] [capacity]", argv[0]);
+        return false;
+    }
+    if (batch < 1 || batch > RINGBENCH_MAX_BATCH || capacity < 1) {
+        report(1, "Batch must be 1 to %d, capacity positive",
+               RINGBENCH_MAX_BATCH);
+        return false;
+    }
+
+    ringbench_t bench = {
+        .r = ring_new(capacity),
+        .count = count,
+        .batch = batch,
+    };
+    if (!bench.r) {
+        report(1, "ERROR: Could not allocate ring");
+        return false;
+    }
+
+    /* Signals such as the time limit must reach this thread only */
+    sigset_t block, old;
+    sigemptyset(&block);
+    sigaddset(&block, SIGALRM);
+    pthread_sigmask(SIG_BLOCK, &block, &old);
+
+    struct timespec start, end;
+    pthread_t producer, consumer;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    bool started = !pthread_create(&producer, NULL, ringbench_producer, &bench);
+    if (started &&
+        pthread_create(&consumer, NULL, ringbench_consumer, &bench)) {
+        /* Consume on this thread instead */
+        ringbench_consumer(&bench);
+        pthread_join(producer, NULL);
+    } else if (started) {
+        pthread_join(producer, NULL);
+        pthread_join(consumer, NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    ring_free(bench.r);
+
+    if (!started) {
+        report(1, "ERROR: Could not start producer thread");
+        return false;
+    }
+
+    double secs =
+        (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    report(1, "batch %d, capacity %zu: %d elements in %.3f s, %.2f M ops/s",
+           batch, (size_t) capacity, bench.count, secs,
+           2 * bench.count / secs / 1e6);
+    if (bench.alloc_failed) {
+        report(1, "ERROR: Could not allocate element %d, benchmark stopped",
+               bench.count);
+        return false;
+    }
+    if (bench.errors) {
+        report(1, "ERROR: %d elements out of order", bench.errors);
+        return false;
+    }
+    return !error_check();
+}
+
 static bool do_free(int argc, char *argv[])
 {
+    if (backend == BACKEND_RING)
+        return ring_free_cmd(argc, argv);
+
     if (argc != 1) {
         report(1, "%s takes no arguments", argv[0]);
         return false;
@@ -104,9 +597,6 @@ static bool do_free(int argc, char *argv[])
     }
     error_check();
 
-    if (current && current->size > BIG_LIST_SIZE)
-        set_cautious_mode(false);
-
     struct list_head *qnext = NULL;
     if (chain.size > 1) {
         qnext = (current->chain.next == &chain.head) ? chain.head.next
@@ -117,9 +607,8 @@ static bool do_free(int argc, char *argv[])
         list_del(&current->chain);
 
         if (exception_setup(true))
-            q_free(current->q);
+            qops->free(current->q);
         exception_cancel();
-        set_cautious_mode(true);
     }
 
     if (current) {
@@ -130,19 +619,15 @@ static bool do_free(int argc, char *argv[])
 
     q_show(3);
 
-    size_t bcnt = allocation_check();
-    if (!chain.size && bcnt > 0) {
-        report(1,
-               "ERROR: There is no queue, but %lu blocks are still allocated",
-               bcnt);
-        ok = false;
-    }
-
+    ok = leak_check() && ok;
     return ok && !error_check();
 }
 
 static bool do_new(int argc, char *argv[])
 {
+    if (backend == BACKEND_RING)
+        return ring_new_cmd(argc, argv);
+
     if (argc != 1) {
         report(1, "%s takes no arguments", argv[0]);
         return false;
@@ -155,7 +640,7 @@ static bool do_new(int argc, char *argv[])
         list_add_tail(&qctx->chain, &chain.head);
 
         qctx->size = 0;
-        qctx->q = q_new();
+        qctx->q = qops->new();
         qctx->id = chain.size++;
 
         current = qctx;
@@ -181,6 +666,45 @@ static void fill_rand_string(char *buf, size_t buf_size)
     buf[len] = '\0';
 }
 
+/* Random strings generated for each bulk insertion */
+#define BULK_RAND_BATCH 1024
+
+/* Insert reps copies of s, or reps random strings if s is NULL, into the
+ * current queue with the bulk API. Return the number of elements inserted
+ * before an allocation failed.
+ */
+static int queue_insert_bulk(position_t pos, char *s, int reps)
+{
+    char(*bufs)[MAX_RANDSTR_LEN] = NULL;
+    char *sv[BULK_RAND_BATCH] = {s};
+    if (!s) {
+        bufs = malloc(BULK_RAND_BATCH * sizeof(*bufs));
+        if (!bufs)
+            return 0;
+    }
+
+    int done = 0;
+    while (done < reps) {
+        int n = reps - done, nsv = 1;
+        if (!s) {
+            n = n < BULK_RAND_BATCH ? n : BULK_RAND_BATCH;
+            for (nsv = 0; nsv < n; nsv++) {
+                fill_rand_string(bufs[nsv], sizeof(*bufs));
+                sv[nsv] = bufs[nsv];
+            }
+        }
+        bool rval = pos == POS_TAIL
+                        ? q_insert_tail_bulk(current->q, sv, nsv, n)
+                        : q_insert_head_bulk(current->q, sv, nsv, n);
+        if (!rval)
+            break;
+        done += n;
+    }
+    free(bufs);
+    current->size += done;
+    return done;
+}
+
 /* insertion */
 static bool queue_insert(position_t pos, int argc, char *argv[])
 {
@@ -228,17 +752,49 @@ static bool queue_insert(position_t pos, int argc, char *argv[])
     error_check();
 
     if (current && exception_setup(true)) {
-        for (int r = 0; ok && r < reps; r++) {
+        int r = 0;
+        /* In bulk mode, repeated insertions go through the bulk API.
+         * Whatever it couldn't allocate is inserted one element at a time
+         * below.
+         */
+        if (bulk_mode && reps > 1 && qops == &list_ops)
+            r = queue_insert_bulk(pos, need_rand ? NULL : inserts, reps);
+        if (r > 0) {
+            element_t *entry =
+                pos == POS_TAIL ? list_last_entry(current->q, element_t, list)
+                                : list_first_entry(current->q, element_t, list);
+            struct list_head *prev =
+                pos == POS_TAIL ? entry->list.prev : entry->list.next;
+            if (!entry->value) {
+                report(1, "ERROR: Failed to save copy of string in queue");
+                ok = false;
+            } else if (entry->value == inserts) {
+                report(1,
+                       "ERROR: Need to allocate and copy string for new "
+                       "queue element");
+                ok = false;
+            } else if (r > 1 && !intern_mode &&
+                       list_entry(prev, element_t, list)->value ==
+                           entry->value) {
+                report(1,
+                       "ERROR: Need to allocate separate string for each "
+                       "queue element");
+                ok = false;
+            }
+            ok = ok && !error_check();
+        }
+        for (; ok && r < reps; r++) {
             if (need_rand)
                 fill_rand_string(randstr_buf, sizeof(randstr_buf));
-            bool rval = pos == POS_TAIL ? q_insert_tail(current->q, inserts)
-                                        : q_insert_head(current->q, inserts);
+            bool rval = pos == POS_TAIL
+                            ? qops->insert_tail(current->q, inserts)
+                            : qops->insert_head(current->q, inserts);
             if (rval) {
                 current->size++;
-                element_t *entry =
-                    pos == POS_TAIL
-                        ? list_last_entry(current->q, element_t, list)
-                        : list_first_entry(current->q, element_t, list);
+                queue_iter_t it;
+                element_t *entry = pos == POS_TAIL
+                                       ? queue_last(current->q)
+                                       : queue_first(current->q, &it);
                 char *cur_inserts = entry->value;
                 if (!cur_inserts) {
                     report(1, "ERROR: Failed to save copy of string in queue");
@@ -249,7 +805,7 @@ static bool queue_insert(position_t pos, int argc, char *argv[])
                            "queue element");
                     ok = false;
                     break;
-                } else if (r == 1 && lasts == cur_inserts) {
+                } else if (r == 1 && !intern_mode && lasts == cur_inserts) {
                     report(1,
                            "ERROR: Need to allocate separate string for each "
                            "queue element");
@@ -280,12 +836,18 @@ static bool queue_insert(position_t pos, int argc, char *argv[])
 /* insert head */
 static bool do_ih(int argc, char *argv[])
 {
+    if (backend == BACKEND_RING) {
+        report(1, "%s is not supported by the ring backend", argv[0]);
+        return false;
+    }
     return queue_insert(POS_HEAD, argc, argv);
 }
 
 /* insert tail */
 static bool do_it(int argc, char *argv[])
 {
+    if (backend == BACKEND_RING)
+        return ring_insert_cmd(argc, argv);
     return queue_insert(POS_TAIL, argc, argv);
 }
 
@@ -352,8 +914,8 @@ static bool queue_remove(position_t pos, int argc, char *argv[])
     element_t *re = NULL;
     if (current && exception_setup(true))
         re = pos == POS_TAIL
-                 ? q_remove_tail(current->q, removes, string_length + 1)
-                 : q_remove_head(current->q, removes, string_length + 1);
+                 ? qops->remove_tail(current->q, removes, string_length + 1)
+                 : qops->remove_head(current->q, removes, string_length + 1);
     exception_cancel();
 
     bool is_null = re ? false : true;
@@ -361,7 +923,7 @@ static bool queue_remove(position_t pos, int argc, char *argv[])
     if (!is_null) {
         // q_remove_head and q_remove_tail are not responsible for releasing
         // node
-        q_release_element(re);
+        release_element(re);
 
         removes[string_length + STRINGPAD] = '\0';
         if (removes[0] == '\0') {
@@ -408,22 +970,321 @@ static bool queue_remove(position_t pos, int argc, char *argv[])
     return ok && !error_check();
 }
 
-static inline bool do_rh(int argc, char *argv[])
+static inline bool do_rh(int argc, char *argv[])
+{
+    if (backend == BACKEND_RING)
+        return ring_remove_cmd(argc, argv);
+    return queue_remove(POS_HEAD, argc, argv);
+}
+
+static inline bool do_rt(int argc, char *argv[])
+{
+    if (backend == BACKEND_RING) {
+        report(1, "%s is not supported by the ring backend", argv[0]);
+        return false;
+    }
+    return queue_remove(POS_TAIL, argc, argv);
+}
+
+typedef enum {
+    CUT_HEAD,
+    CUT_TAIL,
+    CUT_RANGE,
+} cut_t;
+
+/* Move part of the current queue to a new queue at the end of the chain,
+ * which then becomes the current queue.
+ */
+static bool queue_cut(cut_t kind, int argc, char *argv[])
+{
+    int a = 0, b = 0;
+    if (argc != (kind == CUT_RANGE ? 3 : 2) || !get_int(argv[1], &a) ||
+        (kind == CUT_RANGE && !get_int(argv[2], &b))) {
+        report(1, "%s needs %s", argv[0], kind == CUT_RANGE ? "from to" : "n");
+        return false;
+    }
+    if (!list_backend_only(argv[0]))
+        return false;
+    if (!current || !current->q) {
+        report(3, "Warning: Calling %s on null queue", argv[0]);
+        return false;
+    }
+
+    int n = a < current->size ? a : current->size;
+    if (kind == CUT_RANGE)
+        n = b - a;
+    if (a < 0 || n < 0 || (kind == CUT_RANGE && b > current->size)) {
+        report(1, "ERROR: No such range in a queue of %d elements",
+               current->size);
+        return false;
+    }
+
+    queue_contex_t *qctx = malloc(sizeof(queue_contex_t));
+    if (!qctx) {
+        report(1, "INTERNAL ERROR.  Could not allocate queue context");
+        return false;
+    }
+    error_check();
+
+    struct list_head *q = NULL;
+    if (exception_setup(true)) {
+        q = kind == CUT_HEAD   ? q_remove_head_n(current->q, a)
+            : kind == CUT_TAIL ? q_remove_tail_n(current->q, a)
+                               : q_splice_out(current->q, a, b);
+    }
+    exception_cancel();
+
+    bool ok = true;
+    if (!q) {
+        free(qctx);
+        fail_count++;
+        if (fail_count < fail_limit) {
+            report(2, "Moving elements to a new queue failed");
+        } else {
+            report(1,
+                   "ERROR: Moving elements to a new queue failed (%d failures "
+                   "total)",
+                   fail_count);
+            ok = false;
+        }
+        return ok && !error_check();
+    }
+
+    current->size -= n;
+    if (q_size(current->q) != current->size || q_size(q) != n) {
+        report(1, "ERROR: Moved %d elements, leaving %d, instead of %d and %d",
+               q_size(q), q_size(current->q), n, current->size);
+        ok = false;
+    }
+    list_add_tail(&qctx->chain, &chain.head);
+    qctx->q = q;
+    qctx->size = n;
+    qctx->id = chain.size++;
+    current = qctx;
+    report(2, "Moved %d elements to queue %d", n, qctx->id);
+
+    q_show(3);
+    return ok && !error_check();
+}
+
+static bool do_rhn(int argc, char *argv[])
+{
+    return queue_cut(CUT_HEAD, argc, argv);
+}
+
+static bool do_rtn(int argc, char *argv[])
+{
+    return queue_cut(CUT_TAIL, argc, argv);
+}
+
+static bool do_cut(int argc, char *argv[])
+{
+    return queue_cut(CUT_RANGE, argc, argv);
+}
+
+static bool do_compact(int argc, char *argv[])
+{
+    if (argc != 1) {
+        report(1, "%s takes no arguments", argv[0]);
+        return false;
+    }
+    if (!list_backend_only(argv[0]))
+        return false;
+    if (!current || !current->q) {
+        report(3, "Warning: Calling compact on null queue");
+        return false;
+    }
+    error_check();
+
+    bool ok = false;
+    if (exception_setup(true))
+        ok = q_compact(current->q);
+    exception_cancel();
+
+    if (!ok) {
+        fail_count++;
+        if (fail_count < fail_limit) {
+            report(2, "Compacting the queue failed");
+            ok = true;
+        } else {
+            report(1, "ERROR: Compacting the queue failed (%d failures total)",
+                   fail_count);
+        }
+    } else if (q_size(current->q) != current->size) {
+        report(1, "ERROR: Queue has %d elements after compacting, not %d",
+               q_size(current->q), current->size);
+        ok = false;
+    }
+    q_show(3);
+    return ok && !error_check();
+}
+
+/* Report a failed positional operation, an error once fail_limit is reached */
+static bool position_failed(const char *what)
+{
+    fail_count++;
+    if (fail_count < fail_limit) {
+        report(2, "%s failed", what);
+        return true;
+    }
+    report(1, "ERROR: %s failed (%d failures total)", what, fail_count);
+    return false;
+}
+
+static bool do_get(int argc, char *argv[])
+{
+    int i;
+    if ((argc != 2 && argc != 3) || !get_int(argv[1], &i)) {
+        report(1, "%s needs i [str]", argv[0]);
+        return false;
+    }
+    if (!list_backend_only(argv[0]))
+        return false;
+    if (!current || !current->q) {
+        report(3, "Warning: Calling get on null queue");
+        return false;
+    }
+    error_check();
+
+    element_t *e = NULL;
+    if (exception_setup(true))
+        e = q_get(current->q, i);
+    exception_cancel();
+
+    bool ok = true;
+    if (!e) {
+        if (i >= 0 && i < current->size) {
+            report(1, "ERROR: No element at position %d of %d", i,
+                   current->size);
+            ok = false;
+        } else {
+            report(2, "No position %d in a queue of %d elements", i,
+                   current->size);
+        }
+    } else if (argc == 3 && strcmp(e->value, argv[2])) {
+        report(1, "ERROR: Element %d is %s, not the expected %s", i, e->value,
+               argv[2]);
+        ok = false;
+    } else {
+        report(2, "Element %d is %s", i, e->value);
+    }
+    return ok && !error_check();
+}
+
+static bool do_insat(int argc, char *argv[])
+{
+    int i, reps = 1;
+    if ((argc != 3 && argc != 4) || !get_int(argv[1], &i) ||
+        (argc == 4 && !get_int(argv[3], &reps))) {
+        report(1, "%s needs i str [n]", argv[0]);
+        return false;
+    }
+    if (!list_backend_only(argv[0]))
+        return false;
+    if (!current || !current->q) {
+        report(3, "Warning: Calling insat on null queue");
+        return false;
+    }
+    error_check();
+
+    bool ok = true;
+    for (int r = 0; ok && r < reps; r++) {
+        bool done = false;
+        if (exception_setup(true))
+            done = q_insert_at(current->q, i, argv[2]);
+        exception_cancel();
+        if (done)
+            current->size++;
+        else
+            ok = position_failed("Insertion at a position");
+    }
+    q_show(3);
+    return ok && !error_check();
+}
+
+static bool do_delat(int argc, char *argv[])
+{
+    int i, reps = 1;
+    if ((argc != 2 && argc != 3) || !get_int(argv[1], &i) ||
+        (argc == 3 && !get_int(argv[2], &reps))) {
+        report(1, "%s needs i [n]", argv[0]);
+        return false;
+    }
+    if (!list_backend_only(argv[0]))
+        return false;
+    if (!current || !current->q) {
+        report(3, "Warning: Calling delat on null queue");
+        return false;
+    }
+    error_check();
+
+    bool ok = true;
+    for (int r = 0; ok && r < reps; r++) {
+        bool done = false;
+        if (exception_setup(true))
+            done = q_delete_at(current->q, i);
+        exception_cancel();
+        if (done)
+            current->size--;
+        else
+            ok = position_failed("Deletion at a position");
+    }
+    q_show(3);
+    return ok && !error_check();
+}
+
+typedef struct {
+    const char *value;
+    size_t idx;
+} dup_entry_t;
+
+static int dup_entry_cmp(const void *a, const void *b)
 {
-    return queue_remove(POS_HEAD, argc, argv);
+    const dup_entry_t *da = a, *db = b;
+    int r = strcmp(da->value, db->value);
+    if (r)
+        return r;
+    return (da->idx > db->idx) - (da->idx < db->idx);
 }
 
-static inline bool do_rt(int argc, char *argv[])
+/* Flag every element of l whose string occurs more than once in l.
+ * Return an array indexed by position, or NULL if out of memory.
+ */
+static bool *find_dups(struct list_head *l, size_t n)
 {
-    return queue_remove(POS_TAIL, argc, argv);
+    bool *dups = calloc(n ? n : 1, sizeof(bool));
+    dup_entry_t *entries = malloc((n ? n : 1) * sizeof(dup_entry_t));
+    if (!dups || !entries) {
+        free(dups);
+        free(entries);
+        return NULL;
+    }
+
+    size_t i = 0;
+    element_t *item;
+    list_for_each_entry (item, l, list) {
+        entries[i].value = item->value;
+        entries[i].idx = i;
+        i++;
+    }
+    qsort(entries, n, sizeof(dup_entry_t), dup_entry_cmp);
+    for (i = 1; i < n; i++) {
+        if (!strcmp(entries[i - 1].value, entries[i].value))
+            dups[entries[i - 1].idx] = dups[entries[i].idx] = true;
+    }
+    free(entries);
+    return dups;
 }
 
 static bool do_dedup(int argc, char *argv[])
 {
-    if (argc != 1) {
-        report(1, "%s takes no arguments", argv[0]);
+    bool hash = argc == 2 && !strcmp(argv[1], "hash");
+    if (argc != 1 && !hash) {
+        report(1, "%s takes no arguments or 'hash'", argv[0]);
         return false;
     }
+    if (hash && !list_backend_only("dedup hash"))
+        return false;
 
     if (!current || !current->q) {
         report(3, "Warning: Try to access null queue");
@@ -432,10 +1293,12 @@ static bool do_dedup(int argc, char *argv[])
 
     LIST_HEAD(l_copy);
     element_t *item = NULL, *tmp = NULL;
+    queue_iter_t it;
 
     // Copy current->q to l_copy
     if (current->q && !list_empty(current->q)) {
-        list_for_each_entry (item, current->q, list) {
+        for (item = queue_first(current->q, &it); item;
+             item = queue_next(current->q, &it)) {
             size_t slen;
             tmp = malloc(sizeof(element_t));
             if (!tmp)
@@ -451,7 +1314,22 @@ static bool do_dedup(int argc, char *argv[])
             list_add_tail(&tmp->list, &l_copy);
         }
         // Return false if the loop does not leave properly
-        if (&item->list != current->q) {
+        if (item) {
+            list_for_each_entry_safe (item, tmp, &l_copy, list) {
+                free(item->value);
+                free(item);
+            }
+            report(1,
+                   "INTERNAL ERROR.  Could not allocate space for "
+                   "duplicate checking");
+            return false;
+        }
+    }
+
+    bool *dups = NULL;
+    if (hash) {
+        dups = find_dups(&l_copy, current->size);
+        if (!dups) {
             list_for_each_entry_safe (item, tmp, &l_copy, list) {
                 free(item->value);
                 free(item);
@@ -465,7 +1343,8 @@ static bool do_dedup(int argc, char *argv[])
 
     bool ok = true;
     if (exception_setup(true))
-        ok = q_delete_dup(current->q);
+        ok = hash ? q_delete_dup_hash(current->q)
+                  : qops->delete_dup(current->q);
     exception_cancel();
 
     if (!ok) {
@@ -473,12 +1352,14 @@ static bool do_dedup(int argc, char *argv[])
             free(item->value);
             free(item);
         }
+        free(dups);
         report(1, "ERROR: Calling delete duplicate on null queue");
         return false;
     }
 
-    struct list_head *l_tmp = current->q->next;
+    element_t *cur_item = queue_first(current->q, &it);
     bool is_this_dup = false;
+    size_t idx = 0;
     // Compare between new list and old one
     list_for_each_entry (item, &l_copy, list) {
         // Skip comparison with new list if the string is duplicate
@@ -486,19 +1367,19 @@ static bool do_dedup(int argc, char *argv[])
             item->list.next != &l_copy &&
             strcmp(list_entry(item->list.next, element_t, list)->value,
                    item->value) == 0;
+        if (hash)
+            is_this_dup = is_next_dup = dups[idx++];
         if (is_this_dup || is_next_dup) {
             // Update list size
             current->size--;
-        } else if (l_tmp != current->q &&
-                   strcmp(list_entry(l_tmp, element_t, list)->value,
-                          item->value) == 0)
-            l_tmp = l_tmp->next;
+        } else if (cur_item && strcmp(cur_item->value, item->value) == 0)
+            cur_item = queue_next(current->q, &it);
         else
             ok = false;
         is_this_dup = is_next_dup;
     }
     // All elements in new list should be traversed
-    ok = ok && l_tmp == current->q;
+    ok = ok && !cur_item;
     if (!ok)
         report(1,
                "ERROR: Duplicate strings are in queue or distinct strings are "
@@ -508,6 +1389,7 @@ static bool do_dedup(int argc, char *argv[])
         free(item->value);
         free(item);
     }
+    free(dups);
 
     q_show(3);
     return ok && !error_check();
@@ -526,7 +1408,7 @@ static bool do_reverse(int argc, char *argv[])
 
     set_noallocate_mode(true);
     if (current && exception_setup(true))
-        q_reverse(current->q);
+        qops->reverse(current->q);
     exception_cancel();
 
     set_noallocate_mode(false);
@@ -541,22 +1423,33 @@ static bool do_shuffle(int argc, char *argv[])
         return false;
     }
 
+    if (!list_backend_only(argv[0]))
+        return false;
+
     if (!current || !current->q)
         report(3, "Warning: Try to access null queue");
     error_check();
 
-    set_noallocate_mode(true);
+    /* q_shuffle may use a temporary array, but must give it back */
+    size_t bcnt = allocation_check();
     if (current && exception_setup(true))
         q_shuffle(current->q);
     exception_cancel();
 
-    set_noallocate_mode(false);
+    bool ok = true;
+    if (allocation_check() != bcnt) {
+        report(1, "ERROR: Shuffle changed the number of allocated blocks");
+        ok = false;
+    }
     q_show(3);
-    return !error_check();
+    return ok && !error_check();
 }
 
 static bool do_size(int argc, char *argv[])
 {
+    if (backend == BACKEND_RING)
+        return ring_size_cmd(argc, argv);
+
     if (argc != 1 && argc != 2) {
         report(1, "%s takes 0-1 arguments", argv[0]);
         return false;
@@ -581,7 +1474,7 @@ static bool do_size(int argc, char *argv[])
 
     if (current && exception_setup(true)) {
         for (int r = 0; ok && r < reps; r++) {
-            cnt = q_size(current->q);
+            cnt = qops->size(current->q);
             ok = ok && !error_check();
         }
     }
@@ -614,7 +1507,7 @@ bool do_sort(int argc, char *argv[])
     if (!current || !current->q)
         report(3, "Warning: Calling sort on null queue");
     else
-        cnt = q_size(current->q);
+        cnt = qops->size(current->q);
     error_check();
 
     if (cnt < 2)
@@ -623,7 +1516,57 @@ bool do_sort(int argc, char *argv[])
 
     set_noallocate_mode(true);
     if (current && exception_setup(true))
-        q_sort(current->q, descend);
+        qops->sort(current->q, descend);
+    exception_cancel();
+    set_noallocate_mode(false);
+
+    bool ok = true;
+    if (current && current->size) {
+        queue_iter_t it;
+        element_t *item = queue_first(current->q, &it), *next_item;
+        for (; --cnt && (next_item = queue_next(current->q, &it));
+             item = next_item) {
+            /* Ensure each element in ascending/descending order */
+            if (!descend && strcmp(item->value, next_item->value) > 0) {
+                report(1, "ERROR: Not sorted in ascending order");
+                ok = false;
+                break;
+            }
+
+            if (descend && strcmp(item->value, next_item->value) < 0) {
+                report(1, "ERROR: Not sorted in descending order");
+                ok = false;
+                break;
+            }
+        }
+    }
+
+    q_show(3);
+    return ok && !error_check();
+}
+
+bool do_listsort(int argc, char *argv[])
+{
+    if (argc != 1) {
+        report(1, "%s takes no arguments", argv[0]);
+        return false;
+    }
+    if (!list_backend_only(argv[0]))
+        return false;
+
+    int cnt = 0;
+    if (!current || !current->q)
+        report(3, "Warning: Calling sort on null queue");
+    else
+        cnt = q_size(current->q);
+    error_check();
+
+    if (cnt < 2)
+        report(3, "Warning: Calling sort on single node");
+    error_check();
+    set_noallocate_mode(true);
+    if (current && exception_setup(true))
+        list_sort(current->q);
     exception_cancel();
     set_noallocate_mode(false);
 
@@ -653,12 +1596,14 @@ bool do_sort(int argc, char *argv[])
     return ok && !error_check();
 }
 
-bool do_listsort(int argc, char *argv[])
+bool do_timsort(int argc, char *argv[])
 {
     if (argc != 1) {
         report(1, "%s takes no arguments", argv[0]);
         return false;
     }
+    if (!list_backend_only(argv[0]))
+        return false;
 
     int cnt = 0;
     if (!current || !current->q)
@@ -672,7 +1617,7 @@ bool do_listsort(int argc, char *argv[])
     error_check();
     set_noallocate_mode(true);
     if (current && exception_setup(true))
-        list_sort(current->q);
+        timsort(current->q);
     exception_cancel();
     set_noallocate_mode(false);
 
@@ -702,12 +1647,14 @@ bool do_listsort(int argc, char *argv[])
     return ok && !error_check();
 }
 
-bool do_timsort(int argc, char *argv[])
+bool do_radixsort(int argc, char *argv[])
 {
     if (argc != 1) {
         report(1, "%s takes no arguments", argv[0]);
         return false;
     }
+    if (!list_backend_only(argv[0]))
+        return false;
 
     int cnt = 0;
     if (!current || !current->q)
@@ -721,7 +1668,7 @@ bool do_timsort(int argc, char *argv[])
     error_check();
     set_noallocate_mode(true);
     if (current && exception_setup(true))
-        timsort(current->q);
+        radixsort(current->q, descend);
     exception_cancel();
     set_noallocate_mode(false);
 
@@ -766,7 +1713,7 @@ static bool do_dm(int argc, char *argv[])
 
     bool ok = true;
     if (exception_setup(true))
-        ok = q_delete_mid(current->q);
+        ok = qops->delete_mid(current->q);
     exception_cancel();
 
     if (!current->size)
@@ -792,7 +1739,7 @@ static bool do_swap(int argc, char *argv[])
 
     set_noallocate_mode(true);
     if (exception_setup(true))
-        q_swap(current->q);
+        qops->swap(current->q);
     exception_cancel();
 
     set_noallocate_mode(false);
@@ -817,7 +1764,7 @@ static bool do_ascend(int argc, char *argv[])
     error_check();
 
 
-    int cnt = q_size(current->q);
+    int cnt = qops->size(current->q);
     if (!cnt)
         report(3, "Warning: Calling ascend on empty queue");
     else if (cnt < 2)
@@ -825,18 +1772,17 @@ static bool do_ascend(int argc, char *argv[])
     error_check();
 
     if (exception_setup(true))
-        current->size = q_ascend(current->q);
+        current->size = qops->ascend(current->q);
     set_noallocate_mode(false);
 
     bool ok = true;
 
     cnt = current->size;
     if (current->size) {
-        for (struct list_head *cur_l = current->q->next;
-             cur_l != current->q && --cnt; cur_l = cur_l->next) {
-            element_t *item, *next_item;
-            item = list_entry(cur_l, element_t, list);
-            next_item = list_entry(cur_l->next, element_t, list);
+        queue_iter_t it;
+        element_t *item = queue_first(current->q, &it), *next_item;
+        for (; --cnt && (next_item = queue_next(current->q, &it));
+             item = next_item) {
             if (strcmp(item->value, next_item->value) > 0) {
                 report(1,
                        "ERROR: At least one node violated the ordering rule");
@@ -864,7 +1810,7 @@ static bool do_descend(int argc, char *argv[])
     error_check();
 
 
-    int cnt = q_size(current->q);
+    int cnt = qops->size(current->q);
     if (!cnt)
         report(3, "Warning: Calling descend on empty queue");
     else if (cnt < 2)
@@ -872,18 +1818,17 @@ static bool do_descend(int argc, char *argv[])
     error_check();
 
     if (exception_setup(true))
-        current->size = q_descend(current->q);
+        current->size = qops->descend(current->q);
     set_noallocate_mode(false);
 
     bool ok = true;
 
     cnt = current->size;
     if (current->size) {
-        for (struct list_head *cur_l = current->q->next;
-             cur_l != current->q && --cnt; cur_l = cur_l->next) {
-            element_t *item, *next_item;
-            item = list_entry(cur_l, element_t, list);
-            next_item = list_entry(cur_l->next, element_t, list);
+        queue_iter_t it;
+        element_t *item = queue_first(current->q, &it), *next_item;
+        for (; --cnt && (next_item = queue_next(current->q, &it));
+             item = next_item) {
             if (strcmp(item->value, next_item->value) < 0) {
                 report(1,
                        "ERROR: At least one node violated the ordering rule");
@@ -919,7 +1864,7 @@ static bool do_reverseK(int argc, char *argv[])
 
     set_noallocate_mode(true);
     if (exception_setup(true))
-        q_reverseK(current->q, k);
+        qops->reverseK(current->q, k);
     exception_cancel();
 
     set_noallocate_mode(false);
@@ -943,11 +1888,11 @@ static bool do_merge(int argc, char *argv[])
     int len = 0;
     set_noallocate_mode(true);
     if (current && exception_setup(true))
-        len = q_merge(&chain.head, descend);
+        len = qops->merge(&chain.head, descend);
     exception_cancel();
     set_noallocate_mode(false);
 
-    if (q_size(&chain.head) > 1) {
+    if (chain.size > 1) {
         chain.size = 1;
         current = list_entry(chain.head.next, queue_contex_t, chain);
         current->size = len;
@@ -956,7 +1901,7 @@ static bool do_merge(int argc, char *argv[])
         while ((uintptr_t) cur != (uintptr_t) &chain.head) {
             queue_contex_t *ctx = list_entry(cur, queue_contex_t, chain);
             cur = cur->next;
-            q_free(ctx->q);
+            qops->free(ctx->q);
             free(ctx);
         }
 
@@ -966,12 +1911,11 @@ static bool do_merge(int argc, char *argv[])
 
     bool ok = true;
     if (current && current->size) {
-        for (struct list_head *cur_l = current->q->next;
-             cur_l != current->q && --len; cur_l = cur_l->next) {
+        queue_iter_t it;
+        element_t *item = queue_first(current->q, &it), *next_item;
+        for (; --len && (next_item = queue_next(current->q, &it));
+             item = next_item) {
             /* Ensure each element in ascending order */
-            element_t *item, *next_item;
-            item = list_entry(cur_l, element_t, list);
-            next_item = list_entry(cur_l->next, element_t, list);
             if (!descend && strcmp(item->value, next_item->value) > 0) {
                 report(1,
                        "ERROR: Not sorted in ascending order (It might because "
@@ -1000,24 +1944,26 @@ static bool do_merge(int argc, char *argv[])
 
 static bool is_circular()
 {
-    struct list_head *cur = current->q->next;
-    while (cur != current->q) {
-        if (!cur)
-            return false;
-        cur = cur->next;
-    }
-
-    cur = current->q->prev;
-    while (cur != current->q) {
-        if (!cur)
+    /* Walk both directions in the same loop, so that their cache misses
+     * overlap instead of adding up.
+     */
+    struct list_head *f = current->q->next, *b = current->q->prev;
+    while (f != current->q || b != current->q) {
+        if (!f || !b)
             return false;
-        cur = cur->prev;
+        if (f != current->q)
+            f = f->next;
+        if (b != current->q)
+            b = b->prev;
     }
     return true;
 }
 
 static bool q_show(int vlevel)
 {
+    if (backend == BACKEND_RING)
+        return ring_show(vlevel);
+
     bool ok = true;
     if (verblevel < vlevel)
         return true;
@@ -1035,12 +1981,12 @@ static bool q_show(int vlevel)
 
     report_noreturn(vlevel, "l = [");
 
-    struct list_head *ori = current->q;
-    struct list_head *cur = current->q->next;
+    queue_iter_t it;
+    element_t *e = NULL;
 
     if (exception_setup(true)) {
-        while (ok && ori != cur && cnt < current->size) {
-            element_t *e = list_entry(cur, element_t, list);
+        for (e = queue_first(current->q, &it); ok && e && cnt < current->size;
+             e = queue_next(current->q, &it)) {
             if (cnt < BIG_LIST_SIZE) {
                 report_noreturn(vlevel, cnt == 0 ? "%s" : " %s", e->value);
                 if (show_entropy) {
@@ -1050,7 +1996,6 @@ static bool q_show(int vlevel)
                 }
             }
             cnt++;
-            cur = cur->next;
             ok = ok && !error_check();
         }
     }
@@ -1061,7 +2006,7 @@ static bool q_show(int vlevel)
         return false;
     }
 
-    if (cur == ori) {
+    if (!e) {
         if (cnt <= BIG_LIST_SIZE)
             report(vlevel, "]");
         else
@@ -1076,6 +2021,322 @@ static bool q_show(int vlevel)
     return ok;
 }
 
+static bool do_memstat(int argc, char *argv[])
+{
+    if (argc > 2 || (argc == 2 && strcmp(argv[1], "reset"))) {
+        report(1, "%s takes no arguments or 'reset'", argv[0]);
+        return false;
+    }
+
+    if (argc == 2) {
+        memstat_reset();
+    } else {
+        memstat_report();
+        report(1, "Interned strings: %zu", intern_count());
+    }
+    return true;
+}
+
+static bool do_failsite(int argc, char *argv[])
+{
+    if (argc == 1) {
+        fault_clear_sites();
+        return true;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        char *colon = strrchr(argv[i], ':');
+        int line;
+        if (!colon || !get_int(colon + 1, &line)) {
+            report(1, "Expected file:line, got '%s'", argv[i]);
+            return false;
+        }
+        *colon = '\0';
+        if (!fault_add_site(argv[i], line)) {
+            report(1, "Cannot add more failing call sites");
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool do_mpnew(int argc, char *argv[])
+{
+    if (argc != 1) {
+        report(1, "%s takes no arguments", argv[0]);
+        return false;
+    }
+
+    if (mpq)
+        mpmc_free(mpq);
+    error_check();
+    if (exception_setup(true))
+        mpq = mpmc_new();
+    exception_cancel();
+    if (!mpq)
+        report(1, "ERROR: Could not create mpmc queue");
+    return mpq && !error_check();
+}
+
+static bool do_mpfree(int argc, char *argv[])
+{
+    if (argc != 1) {
+        report(1, "%s takes no arguments", argv[0]);
+        return false;
+    }
+
+    error_check();
+    if (exception_setup(true))
+        mpmc_free(mpq);
+    exception_cancel();
+    mpq = NULL;
+    bool ok = leak_check();
+    return ok && !error_check();
+}
+
+static bool do_mpit(int argc, char *argv[])
+{
+    int reps = 1;
+    if (argc != 2 && argc != 3) {
+        report(1, "%s needs 1-2 arguments", argv[0]);
+        return false;
+    }
+    if (argc == 3 && !get_int(argv[2], &reps)) {
+        report(1, "Invalid number of insertions '%s'", argv[2]);
+        return false;
+    }
+    if (!mpq) {
+        report(3, "Warning: Calling insert tail on null mpmc queue");
+        return false;
+    }
+
+    bool ok = true;
+    error_check();
+    if (exception_setup(true)) {
+        for (int r = 0; ok && r < reps; r++) {
+            if (!mpmc_insert_tail(mpq, argv[1])) {
+                fail_count++;
+                if (fail_count < fail_limit) {
+                    report(2, "Insertion of %s failed", argv[1]);
+                } else {
+                    report(1,
+                           "ERROR: Insertion of %s failed (%d failures total)",
+                           argv[1], fail_count);
+                    ok = false;
+                }
+            }
+        }
+    }
+    exception_cancel();
+    return ok && !error_check();
+}
+
+static bool do_mprh(int argc, char *argv[])
+{
+    if (argc != 1 && argc != 2) {
+        report(1, "%s needs 0-1 arguments", argv[0]);
+        return false;
+    }
+
+    char removes[MAXSTRING + 1] = "";
+    element_t *re = NULL;
+    error_check();
+    if (exception_setup(true))
+        re = mpmc_remove_head(mpq, removes, sizeof(removes));
+    exception_cancel();
+
+    if (!re) {
+        report(1, "ERROR: Removal from mpmc queue failed");
+        return false;
+    }
+    release_element(re);
+    report(2, "Removed %s from mpmc queue", removes);
+    if (argc == 2 && strcmp(removes, argv[1])) {
+        report(1, "ERROR: Removed value %s != expected value %s", removes,
+               argv[1]);
+        return false;
+    }
+    return !error_check();
+}
+
+static bool do_mpsize(int argc, char *argv[])
+{
+    if (argc != 1) {
+        report(1, "%s takes no arguments", argv[0]);
+        return false;
+    }
+
+    report(1, "mpmc queue size = %zu", mpmc_size(mpq));
+    return true;
+}
+
+#define MPBENCH_MAX_THREADS 32
+
+/**
+ * mpbench_t - State shared by the threads of mpbench
+ * @q: the queue under test
+ * @per_producer: elements each producer inserts
+ * @consumed: elements removed so far
+ * @total: elements inserted by all producers together
+ * @errors: ordering violations or failed insertions seen
+ * @seq_sum: sum of the sequence numbers removed, checked at the end
+ */
+typedef struct {
+    mpmc_t *q;
+    int per_producer;
+    long consumed;
+    long total;
+    long errors;
+    long seq_sum;
+} mpbench_t;
+
+typedef struct {
+    mpbench_t *bench;
+    int id;
+} mpbench_arg_t;
+
+static void *mpbench_producer(void *arg)
+{
+    mpbench_arg_t *a = arg;
+    mpbench_t *b = a->bench;
+    char buf[32];
+    for (int i = 0; i < b->per_producer; i++) {
+        snprintf(buf, sizeof(buf), "%d-%d", a->id, i);
+        /* Injected malloc failures are retried */
+        int tries = 0;
+        while (!mpmc_insert_tail(b->q, buf)) {
+            if (++tries == 1000) {
+                __atomic_fetch_add(&b->errors, 1, __ATOMIC_RELAXED);
+                __atomic_fetch_sub(&b->total, 1, __ATOMIC_RELAXED);
+                break;
+            }
+        }
+    }
+    return NULL;
+}
+
+/* Elements of each producer must come out in the order they went in */
+static void *mpbench_consumer(void *arg)
+{
+    mpbench_t *b = ((mpbench_arg_t *) arg)->bench;
+    int last[MPBENCH_MAX_THREADS];
+    long sum = 0;
+    for (int i = 0; i < MPBENCH_MAX_THREADS; i++)
+        last[i] = -1;
+
+    while (__atomic_load_n(&b->consumed, __ATOMIC_RELAXED) <
+           __atomic_load_n(&b->total, __ATOMIC_RELAXED)) {
+        element_t *e = mpmc_remove_head(b->q, NULL, 0);
+        if (!e) {
+            sched_yield();
+            continue;
+        }
+        __atomic_fetch_add(&b->consumed, 1, __ATOMIC_RELAXED);
+        int id, seq;
+        if (sscanf(e->value, "%d-%d", &id, &seq) != 2 || id < 0 ||
+            id >= MPBENCH_MAX_THREADS || seq <= last[id]) {
+            __atomic_fetch_add(&b->errors, 1, __ATOMIC_RELAXED);
+        } else {
+            last[id] = seq;
+            sum += seq;
+        }
+        release_element(e);
+    }
+    __atomic_fetch_add(&b->seq_sum, sum, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+static bool do_mpbench(int argc, char *argv[])
+{
+    int producers = 0, consumers = 0, count = 1000000;
+    if (argc > 4 || (argc > 1 && !get_int(argv[1], &producers)) ||
+        (argc > 2 && !get_int(argv[2], &consumers)) ||
+        (argc > 3 && !get_int(argv[3], &count))) {
+        report(1, "%s takes [producers] [consumers] [count]", argv[0]);
+        return false;
+    }
+
+    /* By default half of the cores produce and half consume */
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (producers <= 0)
+        producers = cores > 1 ? cores / 2 : 1;
+    if (consumers <= 0)
+        consumers = cores > 1 ? cores / 2 : 1;
+    if (producers > MPBENCH_MAX_THREADS || consumers > MPBENCH_MAX_THREADS) {
+        report(1, "At most %d producers and %d consumers", MPBENCH_MAX_THREADS,
+               MPBENCH_MAX_THREADS);
+        return false;
+    }
+
+    mpbench_t bench = {
+        .q = mpmc_new(),
+        .per_producer = count / producers,
+    };
+    if (!bench.q) {
+        report(1, "ERROR: Could not create mpmc queue");
+        return false;
+    }
+    bench.total = (long) bench.per_producer * producers;
+
+    mpbench_arg_t args[2 * MPBENCH_MAX_THREADS];
+    pthread_t threads[2 * MPBENCH_MAX_THREADS];
+    int nthreads = producers + consumers;
+
+    /* Keep the time limit pending until every thread is joined. The threads
+     * inherit the mask, so SIGALRM never interrupts them, while faults such
+     * as SIGSEGV still reach the handler.
+     */
+    sigset_t block, old;
+    sigemptyset(&block);
+    sigaddset(&block, SIGALRM);
+    pthread_sigmask(SIG_BLOCK, &block, &old);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int started = 0;
+    for (int i = 0; i < nthreads; i++) {
+        args[i].bench = &bench;
+        args[i].id = i < producers ? i : i - producers;
+        if (pthread_create(&threads[i], NULL,
+                           i < producers ? mpbench_producer : mpbench_consumer,
+                           &args[i]))
+            break;
+        started++;
+    }
+    if (started < nthreads) {
+        /* Let whatever was started drain */
+        __atomic_store_n(&bench.total, 0, __ATOMIC_RELAXED);
+    }
+    for (int i = 0; i < started; i++)
+        pthread_join(threads[i], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    mpmc_free(bench.q);
+    if (started < nthreads) {
+        report(1, "ERROR: Could only start %d of %d threads", started,
+               nthreads);
+        return false;
+    }
+
+    double secs =
+        (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    report(1,
+           "%d producers, %d consumers: %ld elements in %.3f s, %.2f M ops/s",
+           producers, consumers, bench.total, secs,
+           2 * bench.total / secs / 1e6);
+
+    long expect = (long) producers * bench.per_producer *
+                  (bench.per_producer - 1) / 2;
+    if (bench.errors || bench.consumed != bench.total ||
+        (bench.total == (long) bench.per_producer * producers &&
+         bench.seq_sum != expect)) {
+        report(1, "ERROR: %ld elements out of order or lost", bench.errors);
+        return false;
+    }
+    return !error_check();
+}
+
 static bool do_show(int argc, char *argv[])
 {
     if (argc != 1) {
@@ -1444,12 +2705,38 @@ static void console_init()
         rt,
         "Remove from tail of queue. Optionally compare to expected value str",
         "[str]");
+    ADD_COMMAND(rhn, "Move the first n elements to a new queue", "n");
+    ADD_COMMAND(rtn, "Move the last n elements to a new queue", "n");
+    ADD_COMMAND(cut, "Move elements [from, to) to a new queue", "from to");
+    ADD_COMMAND(compact, "Move all elements into one block in queue order", "");
+    ADD_COMMAND(get, "Show element i. Optionally compare to expected value str",
+                "i [str]");
+    ADD_COMMAND(insat, "Insert string str at position i n times", "i str [n]");
+    ADD_COMMAND(delat, "Delete the element at position i n times", "i [n]");
     ADD_COMMAND(reverse, "Reverse queue", "");
     ADD_COMMAND(sort, "Sort queue in ascending/descening order", "");
     ADD_COMMAND(size, "Compute queue size n times (default: n == 1)", "[n]");
     ADD_COMMAND(show, "Show queue contents", "");
+    ADD_COMMAND(failsite, "Make mallocs at the call sites fail, or clear them",
+                "[file:line ...]");
+    ADD_COMMAND(mpnew, "Create the lock-free mpmc queue", "");
+    ADD_COMMAND(mpfree, "Free the mpmc queue", "");
+    ADD_COMMAND(mpit, "Insert string at tail of the mpmc queue", "str [n]");
+    ADD_COMMAND(mprh, "Remove from head of the mpmc queue", "[str]");
+    ADD_COMMAND(mpsize, "Show size of the mpmc queue", "");
+    ADD_COMMAND(mpbench,
+                "Measure mpmc throughput with producer and consumer threads",
+                "[producers] [consumers] [count]");
+    ADD_COMMAND(ringbench,
+                "Measure SPSC ring throughput with batched enqueue/dequeue",
+                "[count] [batch] [capacity]");
+    ADD_COMMAND(memstat, "Show allocation statistics of the queue code",
+                "[reset]");
     ADD_COMMAND(dm, "Delete middle node in queue", "");
-    ADD_COMMAND(dedup, "Delete all nodes that have duplicate string", "");
+    ADD_COMMAND(dedup,
+                "Delete all nodes that have duplicate string. With 'hash', "
+                "the queue need not be sorted",
+                "[hash]");
     ADD_COMMAND(merge, "Merge all the queues into one sorted queue", "");
     ADD_COMMAND(swap, "Swap every two adjacent nodes in queue", "");
     ADD_COMMAND(ascend,
@@ -1465,17 +2752,49 @@ static void console_init()
     ADD_COMMAND(shuffle, "Shuffle list", "");
     ADD_COMMAND(listsort, "Using the list_sort from linux kernel version ", "");
     ADD_COMMAND(timsort, "Using the timsort", "");
+    ADD_COMMAND(radixsort, "Using the MSD radix sort", "");
     ADD_COMMAND(ttt, "Play 4x4 Tic-Tac-Toe game", "");
     ADD_COMMAND(tttcoro, "4x4 ai vs ai coroutine version Tic-Tac-Toe game", "");
     add_param("mode", &ttt_mode, "ttt_mode 0: player vs ai 1: ai vs ai", NULL);
     add_param("length", &string_length, "Maximum length of displayed string",
               NULL);
     add_param("malloc", &fail_probability, "Malloc failure probability percent",
-              NULL);
+              fault_update);
+    add_param("failevery", &fail_every, "Fail every Nth malloc (0 = off)",
+              fault_update);
+    add_param("failafter", &fail_after,
+              "Fail mallocs once this many bytes are allocated (0 = off)",
+              fault_update);
+    add_param("failseed", &fail_seed, "Seed for random malloc failures",
+              fault_update);
+    add_named_param("backend", &backend, backend_names,
+                    "Queue implementation: list, ring or unroll",
+                    backend_update);
+    add_param("ringsize", &ring_size_param,
+              "Capacity of rings created in the ring backend", NULL);
+    add_param("guard", &guard_mode,
+              "Put every Nth block against a guard page (0 = off)", NULL);
+    add_param("timeout", &time_limit,
+              "Time limit in seconds for each queue operation", NULL);
     add_param("fail", &fail_limit,
               "Number of times allow queue operations to return false", NULL);
     add_param("descend", &descend,
               "Sort and merge queue in ascending/descending order", NULL);
+    add_param("pool", &pool_mode,
+              "Allocate elements with short strings inline from slabs", NULL);
+    add_param("threads", &sort_threads, "Number of threads used by sort", NULL);
+    add_param("mergemode", &merge_mode,
+              "Merge queues with a min-heap (0) or pairwise in rounds (1)",
+              NULL);
+    add_param("prefix", &prefix_mode,
+              "Compare cached 8-byte key prefixes before calling strcmp", NULL);
+    add_param("intern", &intern_mode,
+              "Share one reference-counted copy of equal strings", NULL);
+    add_param("index", &index_mode,
+              "Keep an order-statistic index for get, insat and delat",
+              index_update);
+    add_param("bulk", &bulk_mode,
+              "Insert repeated elements of ih and it with the bulk API", NULL);
 }
 
 /* Signal handlers */
@@ -1508,22 +2827,22 @@ static void q_init()
 static bool q_quit(int argc, char *argv[])
 {
     report(3, "Freeing queue");
-    if (current && current->size > BIG_LIST_SIZE)
-        set_cautious_mode(false);
-
+    mpmc_free(mpq);
+    mpq = NULL;
+    ring_free(ring);
+    ring = NULL;
     if (exception_setup(true)) {
         struct list_head *cur = chain.head.next;
         while (chain.size > 0) {
             queue_contex_t *qctx = list_entry(cur, queue_contex_t, chain);
             cur = cur->next;
-            q_free(qctx->q);
+            qops->free(qctx->q);
             free(qctx);
             chain.size--;
         }
     }
 
     exception_cancel();
-    set_cautious_mode(true);
 
     size_t bcnt = allocation_check();
     if (bcnt > 0) {
@@ -1648,6 +2967,7 @@ int main(int argc, char *argv[])
      * with the Unix time.
      */
     srand(os_random(getpid() ^ getppid()));
+    mt19937_init(os_random(getpid() ^ getppid()));
 
     q_init();
     init_cmd();
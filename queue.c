@@ -1,20 +1,184 @@
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "bulk.h"
+#include "dedup.h"
+#include "element.h"
+#include "index.h"
+#include "intern.h"
+#include "list_prefetch.h"
 #include "list_sort.h"
+#include "mt19937-64.h"
+#include "pool.h"
 #include "queue.h"
 
+/**
+ * queue_head_t - Header of a queue returned by q_new()
+ * @list: the list head handed out to callers
+ * @size: number of elements, kept up to date by every mutator in this file
+ * @index: positions of the elements while index mode is on
+ *
+ * Callers only ever see @list, so the size can be recovered in O(1) with
+ * container_of() instead of walking the whole ring.
+ */
+typedef struct {
+    struct list_head list;
+    int size;
+    qindex_t index;
+} queue_head_t;
+
+#define q_head(head) container_of(head, queue_head_t, list)
+
+int index_mode = 0;
+
+/* Index of queue, built if stale, NULL when index mode is off or the index
+ * cannot be built. Once index mode is turned off, the tree is dropped here.
+ */
+static qindex_t *q_index(struct list_head *head)
+{
+    qindex_t *ix = &q_head(head)->index;
+    if (!index_mode) {
+        if (ix->root)
+            qindex_clear(ix);
+        return NULL;
+    }
+    if (!ix->valid && !qindex_build(ix, head, q_head(head)->size))
+        return NULL;
+    return ix;
+}
+
+/* Index of queue if it is up to date and index mode is on, NULL otherwise.
+ * Cheap mutators keep only such an index in step and mark any other one
+ * stale, so a queue pays nothing for it while index mode is off.
+ */
+static inline qindex_t *q_live_index(struct list_head *head)
+{
+    qindex_t *ix = &q_head(head)->index;
+    return index_mode && ix->valid ? ix : NULL;
+}
+
+void q_index_update(struct list_head *head)
+{
+    if (head)
+        q_index(head);
+}
+
+/* Mark the index of queue stale after reordering or removing many elements */
+static inline void q_unindex(struct list_head *head)
+{
+    qindex_invalidate(&q_head(head)->index);
+}
+
+/**
+ * node_t - Memory layout of every element handed out by this file
+ * @key: first 8 bytes of the string as a big-endian integer, see str_key()
+ * @pooled: whether the node was carved out of element_pool
+ * @interned: whether @e.value is a reference into the intern table
+ * @bulk: offset of the node in its bulk_t in units of 8 bytes, 0 if the node
+ *        was not created by a bulk insertion
+ * @e: the element seen by callers
+ * @inline_value: storage for short strings
+ *
+ * element_t only holds a pointer to its string. Short strings are placed right
+ * behind the element in the same block and @e.value points there, so string
+ * comparisons touch the same cache line as the list links.
+ */
+typedef struct {
+    uint64_t key;
+    bool pooled;
+    bool interned;
+    uint32_t bulk;
+    element_t e;
+    char inline_value[];
+} node_t;
+
+/* Strings of up to this many bytes (terminator included) are stored inline by
+ * malloc-ed nodes.
+ */
+#define SSO_LEN 16
+
+/* Strings of up to this many bytes (terminator included) live inside a pooled
+ * node. Together with the slab back pointer a pool object is then exactly one
+ * 64-byte cache line.
+ */
+#define POOL_INLINE_LEN 16
+
+/* Number of nodes carved out of each slab */
+#define POOL_SLAB_NODES 256
+
+/* Allocate new elements from element_pool instead of two malloc calls */
+int pool_mode = 0;
+
+static pool_t element_pool = POOL_INIT(
+    element_pool, sizeof(node_t) + POOL_INLINE_LEN, POOL_SLAB_NODES);
+
+/* Let the sorts order elements by their cached key before calling strcmp */
+int prefix_mode = 0;
+
+/* Pack the first 8 bytes of s, zero padded, into an integer whose order
+ * matches strcmp on that prefix.
+ */
+static inline uint64_t str_key(const char *s, size_t len)
+{
+    uint64_t key = 0;
+    memcpy(&key, s, len < sizeof(key) ? len : sizeof(key));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    key = __builtin_bswap64(key);
+#endif
+    return key;
+}
+
+/* Compare two elements like strcmp, using the cached key if enabled */
+static inline int node_cmp(const struct list_head *a,
+                           const struct list_head *b)
+{
+    const node_t *na = container_of(a, node_t, e.list);
+    const node_t *nb = container_of(b, node_t, e.list);
+    if (!prefix_mode)
+        return strcmp(na->e.value, nb->e.value);
+
+    if (na->key != nb->key)
+        return na->key < nb->key ? -1 : 1;
+    /* Equal keys ending in a NUL byte mean both strings end inside them */
+    if (!(na->key & 0xff))
+        return 0;
+    return strcmp(na->e.value + sizeof(na->key),
+                  nb->e.value + sizeof(nb->key));
+}
+
+/* Attach the NULL-terminated list behind tail and make the whole chain up to
+ * head circular and doubly linked again.
+ */
+static void build_prev_link(struct list_head *head,
+                            struct list_head *tail,
+                            struct list_head *list)
+{
+    tail->next = list;
+    do {
+        list->prev = tail;
+        tail = list;
+        list = list->next;
+    } while (list);
+
+    tail->next = head;
+    head->prev = tail;
+}
 
 /* Create an empty queue */
 struct list_head *q_new()
 {
-    struct list_head *head = malloc(sizeof(struct list_head));
-    if (head) {
-        INIT_LIST_HEAD(head);
-    }
+    queue_head_t *qh = malloc(sizeof(queue_head_t));
+    if (!qh)
+        return NULL;
 
-    return head;
+    INIT_LIST_HEAD(&qh->list);
+    qh->size = 0;
+    qindex_init(&qh->index);
+    return &qh->list;
 }
 
 /* Free all storage used by queue */
@@ -22,34 +186,203 @@ void q_free(struct list_head *l)
 {
     if (!l)
         return;
-    element_t *free_node;
-    element_t *next_node;
-    list_for_each_entry_safe (free_node, next_node, l, list) {
-        free(free_node->value);
-        free(free_node);
+    /* Release from both ends at once, as two independent chains of loads,
+     * and request the nodes after the next ones and the strings of the next
+     * ones while releasing the current pair.
+     */
+    struct list_head *f = l->next, *b = l->prev;
+    for (int i = q_size(l) / 2; i > 0; i--) {
+        struct list_head *fnext = f->next, *bprev = b->prev;
+        list_prefetch(fnext->next);
+        list_prefetch(bprev->prev);
+        list_prefetch(list_entry(fnext, element_t, list)->value);
+        list_prefetch(list_entry(bprev, element_t, list)->value);
+        release_element(list_entry(f, element_t, list));
+        release_element(list_entry(b, element_t, list));
+        f = fnext;
+        b = bprev;
     }
+    if (f == b && f != l)
+        release_element(list_entry(f, element_t, list));
 
-    free(l);
+    qindex_clear(&q_head(l)->index);
+    free(q_head(l));
     return;
 }
 
-bool new_element(element_t **node, char *s)
+static bool make_element(element_t **node,
+                         char *s,
+                         bool pooled,
+                         bool interned)
 {
-    int len = strlen(s) + 1;
-    (*node) = malloc(sizeof(element_t));
-    char *tmp_s = malloc(len);
-    if (!(*node) || !tmp_s) {
-        free(*node);
-        free(tmp_s);
-        return true;
+    size_t len = strlen(s) + 1;
+    node_t *n;
+    char *tmp_s;
+    if (interned) {
+        n = pooled ? pool_alloc(&element_pool) : malloc(sizeof(node_t));
+        tmp_s = n ? intern_get(s, len) : NULL;
+        if (!tmp_s) {
+            if (n && pooled)
+                pool_free(n);
+            else
+                free(n);
+            return true;
+        }
+    } else if (pooled) {
+        n = pool_alloc(&element_pool);
+        if (!n)
+            return true;
+        tmp_s = len <= POOL_INLINE_LEN ? n->inline_value : malloc(len);
+        if (!tmp_s) {
+            pool_free(n);
+            return true;
+        }
+    } else if (len <= SSO_LEN) {
+        n = malloc(sizeof(node_t) + len);
+        if (!n)
+            return true;
+        tmp_s = n->inline_value;
+    } else {
+        n = malloc(sizeof(node_t));
+        tmp_s = malloc(len);
+        if (!n || !tmp_s) {
+            free(n);
+            free(tmp_s);
+            return true;
+        }
     }
-    strncpy(tmp_s, s, len);
-    (*node)->value = tmp_s;
-
+    if (!interned)
+        memcpy(tmp_s, s, len);
+    n->key = str_key(s, len);
+    n->pooled = pooled;
+    n->interned = interned;
+    n->bulk = 0;
+    n->e.value = tmp_s;
+
+    *node = &n->e;
     INIT_LIST_HEAD(&(*node)->list);
     return false;
 }
 
+bool new_element(element_t **node, char *s)
+{
+    return make_element(node, s, pool_mode, intern_mode);
+}
+
+bool new_malloc_element(element_t **node, char *s)
+{
+    return make_element(node, s, false, false);
+}
+
+/**
+ * bulk_t - Block holding all nodes created by one bulk insertion
+ * @live: number of its nodes not released yet
+ * @nodes: the nodes, each directly followed by its string
+ *
+ * The block is freed together with its last node, so a single node left in a
+ * queue keeps the whole block alive.
+ */
+typedef struct {
+    size_t live;
+    char nodes[];
+} bulk_t;
+
+/* Bytes taken by a bulk node holding a string of len bytes */
+static inline size_t bulk_stride(size_t len)
+{
+    return (sizeof(node_t) + len + 7) & ~(size_t) 7;
+}
+
+/* Lay out a node at p inside block b for the len bytes of s. The node holds
+ * a copy of s, or if interned is set a reference to the shared copy and then
+ * takes bulk_stride(0) bytes only. Return NULL if s could not be interned.
+ */
+static node_t *bulk_node(bulk_t *b,
+                         char *p,
+                         const char *s,
+                         size_t len,
+                         bool interned)
+{
+    node_t *node = (node_t *) p;
+    node->e.value = interned ? intern_get(s, len) : node->inline_value;
+    if (!node->e.value)
+        return NULL;
+    if (!interned)
+        memcpy(node->inline_value, s, len);
+    node->key = str_key(s, len);
+    node->pooled = false;
+    node->interned = interned;
+    node->bulk = (p - (char *) b) / 8;
+    return node;
+}
+
+/* Create n elements in a single block, element i holding a copy of
+ * sv[i % nsv], and link them into list in order or in reverse order.
+ */
+static bool make_bulk(struct list_head *list,
+                      char *const *sv,
+                      size_t nsv,
+                      size_t n,
+                      bool reverse)
+{
+    /* A single string repeated n times is measured only once, and interned
+     * strings take no room in the block at all.
+     */
+    size_t len1 = nsv == 1 ? strlen(sv[0]) + 1 : 0, total = 0;
+    for (size_t i = 0; i < n; i++) {
+        total += intern_mode ? bulk_stride(0)
+                             : bulk_stride(len1 ? len1
+                                                : strlen(sv[i % nsv]) + 1);
+    }
+    /* Node offsets must fit in node_t.bulk */
+    if (total / 8 >= UINT32_MAX)
+        return false;
+
+    bulk_t *b = malloc(sizeof(bulk_t) + total);
+    if (!b)
+        return false;
+    b->live = n;
+
+    char *p = b->nodes;
+    for (size_t i = 0; i < n; i++) {
+        char *s = sv[i % nsv];
+        size_t len = len1 ? len1 : strlen(s) + 1;
+        node_t *node = bulk_node(b, p, s, len, intern_mode);
+        if (!node) {
+            element_t *e;
+            list_for_each_entry (e, list, list)
+                intern_put(e->value);
+            free(b);
+            return false;
+        }
+        if (reverse)
+            list_add(&node->e.list, list);
+        else
+            list_add_tail(&node->e.list, list);
+        p += bulk_stride(intern_mode ? 0 : len);
+    }
+    return true;
+}
+
+void release_element(element_t *e)
+{
+    node_t *n = container_of(e, node_t, e);
+    if (n->interned)
+        intern_put(e->value);
+    if (n->bulk) {
+        bulk_t *b = (bulk_t *) ((char *) n - (size_t) n->bulk * 8);
+        if (!--b->live)
+            free(b);
+        return;
+    }
+    if (!n->interned && e->value != n->inline_value)
+        free(e->value);
+    if (n->pooled)
+        pool_free(n);
+    else
+        free(n);
+}
+
 /* Insert an element at head of queue */
 bool q_insert_head(struct list_head *head, char *s)
 {
@@ -60,6 +393,12 @@ bool q_insert_head(struct list_head *head, char *s)
         return false;
 
     list_add(&node->list, head);
+    qindex_t *ix = q_live_index(head);
+    if (ix)
+        qindex_insert(ix, 0, &node->list);
+    else
+        q_unindex(head);
+    q_head(head)->size++;
     return true;
 }
 
@@ -73,6 +412,48 @@ bool q_insert_tail(struct list_head *head, char *s)
         return false;
 
     list_add_tail(&node->list, head);
+    qindex_t *ix = q_live_index(head);
+    if (ix)
+        qindex_insert(ix, q_size(head), &node->list);
+    else
+        q_unindex(head);
+    q_head(head)->size++;
+    return true;
+}
+
+/* Insert n elements at head of queue, as n calls of q_insert_head() would */
+bool q_insert_head_bulk(struct list_head *head,
+                        char *const *sv,
+                        size_t nsv,
+                        size_t n)
+{
+    if (!head || !sv || !nsv)
+        return false;
+
+    LIST_HEAD(list);
+    if (n && !make_bulk(&list, sv, nsv, n, true))
+        return false;
+    list_splice(&list, head);
+    q_unindex(head);
+    q_head(head)->size += n;
+    return true;
+}
+
+/* Insert n elements at tail of queue, as n calls of q_insert_tail() would */
+bool q_insert_tail_bulk(struct list_head *head,
+                        char *const *sv,
+                        size_t nsv,
+                        size_t n)
+{
+    if (!head || !sv || !nsv)
+        return false;
+
+    LIST_HEAD(list);
+    if (n && !make_bulk(&list, sv, nsv, n, false))
+        return false;
+    list_splice_tail(&list, head);
+    q_unindex(head);
+    q_head(head)->size += n;
     return true;
 }
 
@@ -89,10 +470,161 @@ element_t *q_remove_list(struct list_head *head,
         strncpy(sp, tmp->value, bufsize);
         sp[bufsize - 1] = '\0';
     }
+    qindex_t *ix = q_live_index(head);
+    if (ix)
+        qindex_delete(ix, list_dir == head->next ? 0 : q_size(head) - 1);
+    else
+        q_unindex(head);
     list_del(remove_list);
+    q_head(head)->size--;
     return tmp;
 }
 
+/* Move every element of queue, in list order, into one new block */
+bool q_compact(struct list_head *head)
+{
+    if (!head)
+        return false;
+    if (list_empty(head))
+        return true;
+
+    size_t total = 0;
+    element_t *e, *safe;
+    list_for_each_entry (e, head, list) {
+        bool interned = container_of(e, node_t, e)->interned;
+        total += bulk_stride(interned ? 0 : strlen(e->value) + 1);
+    }
+    if (total / 8 >= UINT32_MAX)
+        return false;
+    bulk_t *b = malloc(sizeof(bulk_t) + total);
+    if (!b)
+        return false;
+    b->live = q_size(head);
+
+    /* Each copy takes the place of its original in the list. Interned strings
+     * stay shared: their table entries exist, so interning cannot fail.
+     */
+    char *p = b->nodes;
+    list_for_each_entry_safe_prefetch (e, safe, head, list) {
+        bool interned = container_of(e, node_t, e)->interned;
+        size_t len = strlen(e->value) + 1;
+        node_t *node = bulk_node(b, p, e->value, len, interned);
+        struct list_head *l = &node->e.list;
+        l->prev = e->list.prev;
+        l->next = e->list.next;
+        l->prev->next = l;
+        l->next->prev = l;
+        release_element(e);
+        p += bulk_stride(interned ? 0 : len);
+    }
+    q_unindex(head);
+    return true;
+}
+
+/* Node at position i, or head itself for i == -1 or i == size. A valid index
+ * answers in O(log n), otherwise walk from whichever end is nearer.
+ */
+static struct list_head *q_node_at(struct list_head *head, int i)
+{
+    int size = q_size(head);
+    struct list_head *node = head;
+    qindex_t *ix = q_live_index(head);
+    if (i >= 0 && i < size && ix)
+        return qindex_get(ix, i);
+    if (i < size / 2) {
+        for (int k = -1; k < i; k++)
+            node = node->next;
+    } else {
+        for (int k = size; k > i; k--)
+            node = node->prev;
+    }
+    return node;
+}
+
+/* Move the elements [from, to) of queue to a new queue */
+struct list_head *q_splice_out(struct list_head *head, int from, int to)
+{
+    if (!head || from < 0 || to < from || to > q_size(head))
+        return NULL;
+    struct list_head *q = q_new();
+    if (!q || from == to)
+        return q;
+
+    struct list_head *before = q_node_at(head, from - 1);
+    struct list_head *last = q_node_at(head, to - 1);
+    struct list_head *first = before->next;
+
+    /* Close the gap, then hang the range off the new head */
+    before->next = last->next;
+    last->next->prev = before;
+    q->next = first;
+    first->prev = q;
+    q->prev = last;
+    last->next = q;
+
+    q_unindex(head);
+    q_head(q)->size = to - from;
+    q_head(head)->size -= to - from;
+    return q;
+}
+
+/* Move the first n elements of queue to a new queue */
+struct list_head *q_remove_head_n(struct list_head *head, int n)
+{
+    if (!head || n < 0)
+        return NULL;
+    return q_splice_out(head, 0, n < q_size(head) ? n : q_size(head));
+}
+
+/* Move the last n elements of queue to a new queue */
+struct list_head *q_remove_tail_n(struct list_head *head, int n)
+{
+    if (!head || n < 0)
+        return NULL;
+    int size = q_size(head);
+    return q_splice_out(head, n < size ? size - n : 0, size);
+}
+
+/* Element at position i of queue */
+element_t *q_get(struct list_head *head, int i)
+{
+    if (!head || i < 0 || i >= q_size(head))
+        return NULL;
+    q_index(head);
+    return list_entry(q_node_at(head, i), element_t, list);
+}
+
+/* Insert an element at position i of queue */
+bool q_insert_at(struct list_head *head, int i, char *s)
+{
+    if (!head || i < 0 || i > q_size(head))
+        return false;
+    element_t *node;
+    if (new_element(&node, s))
+        return false;
+
+    qindex_t *ix = q_index(head);
+    list_add_tail(&node->list, q_node_at(head, i));
+    if (ix)
+        qindex_insert(ix, i, &node->list);
+    q_head(head)->size++;
+    return true;
+}
+
+/* Delete the element at position i of queue */
+bool q_delete_at(struct list_head *head, int i)
+{
+    if (!head || i < 0 || i >= q_size(head))
+        return false;
+
+    qindex_t *ix = q_index(head);
+    struct list_head *node = ix ? qindex_delete(ix, i) : q_node_at(head, i);
+    list_del(node);
+    release_element(list_entry(node, element_t, list));
+    q_head(head)->size--;
+    return true;
+}
+
 /* Remove an element from head of queue */
 element_t *q_remove_head(struct list_head *head, char *sp, size_t bufsize)
 {
@@ -111,12 +643,7 @@ int q_size(struct list_head *head)
     if (!head)
         return 0;
 
-    int len = 0;
-    struct list_head *li;
-
-    list_for_each (li, head)
-        len++;
-    return len;
+    return q_head(head)->size;
 }
 
 /* Delete the middle node in queue */
@@ -125,37 +652,147 @@ bool q_delete_mid(struct list_head *head)
     if (!head || list_empty(head))
         return false;
 
+    qindex_t *ix = q_index(head);
     struct list_head *slow = head->next, *fast = head->next;
-    while (fast != head && fast->next != head) {
-        slow = slow->next;
-        fast = fast->next->next;
+    if (ix) {
+        slow = qindex_delete(ix, q_size(head) / 2);
+    } else {
+        while (fast != head && fast->next != head) {
+            slow = slow->next;
+            fast = fast->next->next;
+        }
     }
     element_t *del_node = list_entry(slow, element_t, list);
     list_del(slow);
-    free(del_node->value);
-    free(del_node);
+    release_element(del_node);
+    q_head(head)->size--;
     return true;
 }
 
+/* Whether two elements hold equal strings. Interned strings are equal exactly
+ * when they are the same copy, so they are never read.
+ */
+static inline bool same_value(element_t *a, element_t *b)
+{
+    if (container_of(a, node_t, e)->interned &&
+        container_of(b, node_t, e)->interned)
+        return a->value == b->value;
+    return !strcmp(a->value, b->value);
+}
+
 /* Delete all nodes that have duplicate string */
 bool q_delete_dup(struct list_head *head)
 {
     if (!head || list_empty(head) || list_is_singular(head))
         return false;
     element_t *node, *safe, *tmp = NULL;
-    list_for_each_entry_safe (node, safe, head, list) {
-        if (&safe->list != head && !strcmp(node->value, safe->value)) {
+    int removed = 0;
+    list_for_each_entry_safe_prefetch (node, safe, head, list) {
+        /* The string compared in the next iteration */
+        if (&safe->list != head && safe->list.next != head)
+            list_prefetch(list_entry(safe->list.next, element_t, list)->value);
+        if (&safe->list != head && same_value(node, safe)) {
             list_del(&node->list);
-            q_release_element(node);
+            release_element(node);
+            removed++;
             tmp = safe;
         } else {
             if (tmp) {
                 list_del(&tmp->list);
-                q_release_element(tmp);
+                release_element(tmp);
+                removed++;
             }
             tmp = NULL;
         }
     }
+    if (removed)
+        q_unindex(head);
+    q_head(head)->size -= removed;
+    return true;
+}
+
+/* FNV-1a, 64-bit */
+static inline uint64_t str_hash(const char *s)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+    while (*s) {
+        h ^= (unsigned char) *s++;
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+/**
+ * dedup_slot_t - Slot of the open-addressing set used by q_delete_dup_hash()
+ * @first: first element seen with this string, NULL for an empty slot
+ * @hash: upper half of the string hash, compared before calling strcmp
+ * @dup: whether the string was seen again
+ */
+typedef struct {
+    element_t *first;
+    uint32_t hash;
+    bool dup;
+} dedup_slot_t;
+
+/* Delete all nodes whose string occurs more than once, sorted or not */
+bool q_delete_dup_hash(struct list_head *head)
+{
+    if (!head)
+        return false;
+    size_t n = q_size(head);
+    if (n < 2)
+        return true;
+
+    /* Keep the load factor at or below one half for short probe sequences */
+    size_t cap = 4;
+    while (cap < 2 * n)
+        cap <<= 1;
+    dedup_slot_t *set = malloc(cap * sizeof(*set));
+    if (!set)
+        return false;
+    memset(set, 0, cap * sizeof(*set));
+
+    /* Later occurrences go right away, the first one once it is known to be
+     * duplicated as well.
+     */
+    element_t *node, *safe;
+    int removed = 0;
+    uint64_t next_h = str_hash(list_first_entry(head, element_t, list)->value);
+    list_for_each_entry_safe_prefetch (node, safe, head, list) {
+        /* Hash the next string and prefetch its slot before probing for this
+         * one, so that the two cache misses overlap.
+         */
+        uint64_t h = next_h;
+        if (&safe->list != head) {
+            next_h = str_hash(safe->value);
+            list_prefetch(&set[next_h & (cap - 1)]);
+        }
+        size_t i = h & (cap - 1);
+        while (set[i].first && (set[i].hash != (uint32_t) (h >> 32) ||
+                                !same_value(set[i].first, node)))
+            i = (i + 1) & (cap - 1);
+        if (!set[i].first) {
+            set[i].first = node;
+            set[i].hash = h >> 32;
+            continue;
+        }
+        set[i].dup = true;
+        list_del(&node->list);
+        release_element(node);
+        removed++;
+    }
+
+    for (size_t i = 0; i < cap; i++) {
+        if (set[i].dup) {
+            list_del(&set[i].first->list);
+            release_element(set[i].first);
+            removed++;
+        }
+    }
+    free(set);
+    if (removed)
+        q_unindex(head);
+    q_head(head)->size -= removed;
     return true;
 }
 
@@ -164,6 +801,7 @@ void q_swap(struct list_head *head)
 {
     if (!head || list_empty(head))
         return;
+    q_unindex(head);
 
     for (struct list_head *n1 = head->next->next, *pre = head;
          n1 != head && n1->prev != head; n1 = pre->next->next) {
@@ -172,15 +810,36 @@ void q_swap(struct list_head *head)
     }
 }
 
+/* Swap the links of a node, so that it points the other way round */
+static inline void flip_node(struct list_head *node)
+{
+    struct list_head *next = node->next;
+    node->next = node->prev;
+    node->prev = next;
+}
+
 /* Reverse elements in queue */
 void q_reverse(struct list_head *head)
 {
     if (!head || list_empty(head))
         return;
-    struct list_head *cur, *safe;
-    list_for_each_safe (cur, safe, head) {
-        list_move(cur, head);
+    q_unindex(head);
+
+    /* Reversing a ring only swaps the links of every node, head included, so
+     * the nodes may be visited in any order. Walk in from both ends at once:
+     * the two chains of loads are independent and their cache misses overlap.
+     */
+    struct list_head *f = head->next, *b = head->prev;
+    for (int i = q_size(head) / 2; i > 0; i--) {
+        struct list_head *fnext = f->next, *bprev = b->prev;
+        flip_node(f);
+        flip_node(b);
+        f = fnext;
+        b = bprev;
     }
+    if (f == b)
+        flip_node(f);
+    flip_node(head);
 }
 
 /* Reverse the nodes of the list k at a time */
@@ -188,17 +847,58 @@ void q_reverseK(struct list_head *head, int k)
 {
     if (!head || list_empty(head) || list_is_singular(head))
         return;
-    int count = 0;
-    struct list_head *node, *safe, *move = head, *record = head->next;
-    list_for_each_safe (node, safe, head) {
-        count += 1;
-        list_move(node, move);
-        if (count == k) {
-            move = record;
-            record = record->next;
-            count = 0;
+
+    /* A trailing group shorter than k is reversed too, k < 1 reverses all */
+    int n = q_size(head);
+    if (k < 1 || k >= n) {
+        q_reverse(head);
+        return;
+    }
+    q_unindex(head);
+
+    /* As in q_reverse(), the links inside each group are swapped in place,
+     * the front half of the groups walking forward from the first node and
+     * the back half walking backward from the last one. Whenever a group is
+     * complete, it is joined to the group finished before it by the same
+     * walk; the two halves are joined at the end.
+     */
+    int groups = (n + k - 1) / k;
+    int m = (groups + 1) / 2 * k;
+
+    struct list_head *f = head->next, *before = head, *ffirst = NULL;
+    struct list_head *b = head->prev, *after = head, *blast = NULL;
+    int fi = 0, bi = (n - 1) % k;
+    for (int i = 0; i < m; i++) {
+        struct list_head *x = f;
+        f = f->next;
+        flip_node(x);
+        if (!ffirst)
+            ffirst = x;
+        if (++fi == k) {
+            before->next = x;
+            x->prev = before;
+            before = ffirst;
+            ffirst = NULL;
+            fi = 0;
+        }
+
+        if (i >= n - m)
+            continue;
+        struct list_head *y = b;
+        b = b->prev;
+        flip_node(y);
+        if (!blast)
+            blast = y;
+        if (!bi--) {
+            y->next = after;
+            after->prev = y;
+            after = blast;
+            blast = NULL;
+            bi = k - 1;
         }
     }
+    before->next = after;
+    after->prev = before;
 }
 
 int cmp(const char *a, const char *b, bool descend)
@@ -216,15 +916,21 @@ struct list_head *merge(struct list_head *l1,
     LIST_HEAD(list);
     INIT_LIST_HEAD(&list);
     struct list_head *tmp = &list;
+    /* Each time a list advances, request the string of the node after its
+     * new first one, which is compared a step later.
+     */
     while (l1 && l2) {
-        element_t *e1 = list_entry(l1, element_t, list),
-                  *e2 = list_entry(l2, element_t, list);
-        if (cmp(e1->value, e2->value, descend) < 0) {
+        int r = node_cmp(l1, l2);
+        if (descend ? r > 0 : r < 0) {
             tmp->next = l1;
             l1 = l1->next;
+            if (l1 && l1->next)
+                list_prefetch(list_entry(l1->next, element_t, list)->value);
         } else {
             tmp->next = l2;
             l2 = l2->next;
+            if (l2 && l2->next)
+                list_prefetch(list_entry(l2->next, element_t, list)->value);
         }
         tmp = tmp->next;
     }
@@ -232,22 +938,157 @@ struct list_head *merge(struct list_head *l1,
     return list.next;
 }
 
-struct list_head *q_mergeSort(struct list_head *head, bool descend)
+/* Sort a NULL-terminated list of n nodes. Knowing the length, the middle is
+ * reached by walking n/2 nodes instead of chasing it with a fast pointer.
+ */
+struct list_head *q_mergeSort(struct list_head *head, size_t n, bool descend)
 {
-    if (!head || !head->next)
+    if (n < 2)
         return head;
 
+    struct list_head *mid = head, *right;
+    for (size_t i = 1; i < n / 2; i++)
+        mid = mid->next;
+    right = mid->next;
+    mid->next = NULL;
+    head = q_mergeSort(head, n / 2, descend);
+    right = q_mergeSort(right, n - n / 2, descend);
+    return merge(head, right, descend);
+}
+
+/* Number of threads q_sort() may use */
+int sort_threads = 1;
 
-    struct list_head *slow = head, *fast = head->next, *right;
-    while (fast && fast->next) {
-        slow = slow->next;
-        fast = fast->next->next;
+#define SORT_MAX_THREADS 64
+
+/* Smallest chunk worth handing to a thread of its own */
+#define SORT_MIN_CHUNK 4096
+
+typedef struct {
+    struct list_head *list;
+    size_t n;
+    bool descend;
+} sort_job_t;
+
+static void *sort_job(void *arg)
+{
+    sort_job_t *job = arg;
+    job->list = q_mergeSort(job->list, job->n, job->descend);
+    return NULL;
+}
+
+/**
+ * sort_pool - Worker threads shared by every parallel sort
+ * @lock: protects the other fields
+ * @work: signaled when a batch of jobs is posted
+ * @done: signaled when the last job of a batch is finished
+ * @jobs: the current batch
+ * @next: index of the next job nobody has taken yet
+ * @njobs: number of jobs in the batch, 0 when idle
+ * @pending: number of jobs not finished yet
+ * @nworkers: number of threads started so far
+ *
+ * Workers are started on demand the first time a sort needs them and then
+ * wait for the next batch instead of exiting. They are created with SIGALRM
+ * blocked, so the time limit is only ever delivered to the main thread.
+ */
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t work, done;
+    sort_job_t *jobs;
+    int next, njobs, pending;
+    int nworkers;
+} sort_pool = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .work = PTHREAD_COND_INITIALIZER,
+    .done = PTHREAD_COND_INITIALIZER,
+};
+
+/* Run jobs of the current batch until none is left, with the lock held */
+static void sort_pool_drain()
+{
+    while (sort_pool.next < sort_pool.njobs) {
+        sort_job_t *job = &sort_pool.jobs[sort_pool.next++];
+        pthread_mutex_unlock(&sort_pool.lock);
+        sort_job(job);
+        pthread_mutex_lock(&sort_pool.lock);
+        if (!--sort_pool.pending)
+            pthread_cond_signal(&sort_pool.done);
     }
-    right = slow->next;
-    slow->next = NULL;
-    head = q_mergeSort(head, descend);
-    right = q_mergeSort(right, descend);
-    return merge(head, right, descend);
+}
+
+static void *sort_worker(void *arg)
+{
+    pthread_mutex_lock(&sort_pool.lock);
+    for (;;) {
+        while (sort_pool.next >= sort_pool.njobs)
+            pthread_cond_wait(&sort_pool.work, &sort_pool.lock);
+        sort_pool_drain();
+    }
+    return NULL;
+}
+
+/* Run njobs jobs on the pool, the calling thread taking its share */
+static void sort_pool_run(sort_job_t *jobs, int njobs)
+{
+    pthread_mutex_lock(&sort_pool.lock);
+    /* A worker that cannot be started only means less parallelism */
+    while (sort_pool.nworkers < njobs - 1) {
+        pthread_t tid;
+        if (pthread_create(&tid, NULL, sort_worker, NULL))
+            break;
+        pthread_detach(tid);
+        sort_pool.nworkers++;
+    }
+
+    sort_pool.jobs = jobs;
+    sort_pool.next = 0;
+    sort_pool.njobs = sort_pool.pending = njobs;
+    pthread_cond_broadcast(&sort_pool.work);
+    sort_pool_drain();
+    while (sort_pool.pending)
+        pthread_cond_wait(&sort_pool.done, &sort_pool.lock);
+    sort_pool.njobs = sort_pool.next = 0;
+    pthread_mutex_unlock(&sort_pool.lock);
+}
+
+/* Split the list into nthreads chunks, sort them concurrently on the pool and
+ * merge the sorted chunks pairwise in log2(nthreads) rounds.
+ */
+static struct list_head *parallel_sort(struct list_head *list,
+                                       size_t n,
+                                       int nthreads,
+                                       bool descend)
+{
+    sort_job_t jobs[SORT_MAX_THREADS];
+
+    /* Keep SIGALRM pending until every chunk is sorted, so that the time
+     * limit cannot longjmp out of here while workers still use the chunks.
+     * Workers started below inherit the mask and never see the signal. Any
+     * other signal, such as SIGSEGV in a worker, is delivered as usual.
+     */
+    sigset_t block, old;
+    sigemptyset(&block);
+    sigaddset(&block, SIGALRM);
+    pthread_sigmask(SIG_BLOCK, &block, &old);
+
+    for (int i = 0; i < nthreads; i++) {
+        size_t len = n / nthreads + ((size_t) i < n % nthreads);
+        jobs[i] = (sort_job_t){.list = list, .n = len, .descend = descend};
+        for (size_t j = 1; j < len; j++)
+            list = list->next;
+        struct list_head *next = list->next;
+        list->next = NULL;
+        list = next;
+    }
+    sort_pool_run(jobs, nthreads);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    for (int step = 1; step < nthreads; step *= 2) {
+        for (int i = 0; i + step < nthreads; i += 2 * step)
+            jobs[i].list = merge(jobs[i].list, jobs[i + step].list, descend);
+    }
+    return jobs[0].list;
 }
 
 /* Sort elements of queue in ascending/descending order */
@@ -255,15 +1096,26 @@ void q_sort(struct list_head *head, bool descend)
 {
     if (!head || list_empty(head))
         return;
+    q_unindex(head);
 
     struct list_head *list = head->next, *pre, *node;
+    size_t n = q_size(head);
+    int nthreads = sort_threads < SORT_MAX_THREADS ? sort_threads
+                                                   : SORT_MAX_THREADS;
+    if ((size_t) nthreads > n / SORT_MIN_CHUNK)
+        nthreads = n / SORT_MIN_CHUNK;
+
     head->prev->next = NULL;
-    head->next = q_mergeSort(list, descend);
+    if (nthreads > 1)
+        head->next = parallel_sort(list, n, nthreads, descend);
+    else
+        head->next = q_mergeSort(list, n, descend);
 
     for (pre = head, node = head->next; node->next != NULL;
          pre = node, node = node->next) {
         node->prev = pre;
     }
+    node->prev = pre;
     node->next = head;
     head->prev = node;
 }
@@ -280,12 +1132,15 @@ int q_remove(struct list_head *head, bool descend)
         element_t *move_ele = list_entry(move, element_t, list);
         if (cmp(cur_ele->value, move_ele->value, descend) < 0) {
             list_del(move);
-            q_release_element(move_ele);
+            release_element(move_ele);
         } else {
             cur = move;
             count += 1;
         }
     }
+    if (count != q_size(head))
+        q_unindex(head);
+    q_head(head)->size = count;
     return count;
 }
 /* Remove every node which has a node with a strictly less value anywhere to
@@ -302,6 +1157,84 @@ int q_descend(struct list_head *head)
     return q_remove(head, true);
 }
 
+/* How q_merge() combines the queues: 0 keeps a min-heap of the queue fronts,
+ * 1 merges pairs of queues in rounds. Both take O(N log k) for k queues.
+ */
+int merge_mode = 0;
+
+/* Most queues the heap can hold; q_merge() may not allocate, so the heap lives
+ * on the stack and larger chains are merged in rounds instead.
+ */
+#define MERGE_HEAP_MAX 1024
+
+static inline bool node_before(struct list_head *a,
+                               struct list_head *b,
+                               bool descend)
+{
+    int r = node_cmp(a, b);
+    return descend ? r > 0 : r < 0;
+}
+
+static void heap_sift_down(struct list_head **heap, int n, int i, bool descend)
+{
+    struct list_head *x = heap[i];
+    for (int c; (c = 2 * i + 1) < n; i = c) {
+        if (c + 1 < n && node_before(heap[c + 1], heap[c], descend))
+            c++;
+        if (!node_before(heap[c], x, descend))
+            break;
+        heap[i] = heap[c];
+    }
+    heap[i] = x;
+}
+
+/* Merge n NULL-terminated sorted runs by repeatedly taking the smallest front
+ * node off a binary min-heap.
+ */
+static struct list_head *merge_heap(struct list_head **heap,
+                                    int n,
+                                    bool descend)
+{
+    struct list_head *result = NULL, **tail = &result;
+
+    for (int i = n / 2 - 1; i >= 0; i--)
+        heap_sift_down(heap, n, i, descend);
+    while (n > 0) {
+        struct list_head *top = heap[0];
+        *tail = top;
+        tail = &top->next;
+        heap[0] = top->next ? top->next : heap[--n];
+        if (n > 0)
+            heap_sift_down(heap, n, 0, descend);
+    }
+    return result;
+}
+
+/* Merge the runs parked in q->next of the k queues in the chain, pairing
+ * queues step apart in each round. The result ends up in the first queue.
+ */
+static struct list_head *merge_rounds(struct list_head *chain,
+                                      int k,
+                                      bool descend)
+{
+    for (int step = 1; step < k; step *= 2) {
+        struct list_head *a = chain->next, *b;
+        for (int i = 0; i + step < k; i += 2 * step) {
+            b = a;
+            for (int j = 0; j < step; j++)
+                b = b->next;
+            struct list_head *qa = list_entry(a, queue_contex_t, chain)->q;
+            struct list_head *qb = list_entry(b, queue_contex_t, chain)->q;
+            qa->next = merge(qa->next, qb->next, descend);
+            qb->next = NULL;
+            a = b;
+            for (int j = 0; j < step && a != chain; j++)
+                a = a->next;
+        }
+    }
+    return list_first_entry(chain, queue_contex_t, chain)->q->next;
+}
+
 /* Merge all the queues into one sorted queue, which is in ascending/descending
  * order */
 int q_merge(struct list_head *head, bool descend)
@@ -309,60 +1242,145 @@ int q_merge(struct list_head *head, bool descend)
     // https://leetcode.com/problems/merge-k-sorted-lists/
     if (!head || list_empty(head))
         return 0;
-    int size = 0;
-    struct list_head *pre, *node, *mrg_q = NULL, *move = head->next;
-    while (move != head) {
-        queue_contex_t *tmp = list_entry(move, queue_contex_t, chain);
-        size += tmp->size;
-        tmp->q->prev->next = NULL;
-        mrg_q = merge(mrg_q, tmp->q->next, descend);
-        move = move->next;
-        INIT_LIST_HEAD(tmp->q);
+
+    int size = 0, k = 0;
+    queue_contex_t *ctx;
+    /* Park every queue as a NULL-terminated run in its head's next pointer */
+    list_for_each_entry (ctx, head, chain) {
+        size += q_size(ctx->q);
+        q_unindex(ctx->q);
+        ctx->q->prev->next = NULL;
+        k++;
+    }
+
+    struct list_head *mrg_q;
+    if (merge_mode == 0 && k <= MERGE_HEAP_MAX) {
+        struct list_head *heap[MERGE_HEAP_MAX];
+        int n = 0;
+        list_for_each_entry (ctx, head, chain) {
+            if (ctx->q->next)
+                heap[n++] = ctx->q->next;
+        }
+        mrg_q = merge_heap(heap, n, descend);
+    } else {
+        mrg_q = merge_rounds(head, k, descend);
     }
+
+    list_for_each_entry (ctx, head, chain) {
+        INIT_LIST_HEAD(ctx->q);
+        q_head(ctx->q)->size = 0;
+    }
+    if (!mrg_q)
+        return 0;
+
+    struct list_head *pre, *node;
     LIST_HEAD(list);
     list.next = mrg_q;
     for (pre = &list, node = list.next; node->next != NULL;
          pre = node, node = node->next) {
         node->prev = pre;
     }
+    node->prev = pre;
     node->next = &list;
     list.prev = node;
-    list_splice(&list, list_first_entry(head, queue_contex_t, chain)->q);
+    struct list_head *first = list_first_entry(head, queue_contex_t, chain)->q;
+    list_splice(&list, first);
+    q_head(first)->size = size;
     return size;
 }
 
-void swap(struct list_head *n1, struct list_head *n2)
+/* Uniform random number in [0, n), using Lemire's multiply-shift with
+ * rejection instead of the biased rand() % n.
+ */
+static inline uint64_t rand_below(uint64_t n)
 {
-    struct list_head *pre, *pn;
-    pre = n1->prev, pn = n2->next;
-    list_move(n2, pre);
-    list_move_tail(n1, pn);
+    __uint128_t m = (__uint128_t) mt19937_rand() * n;
+    if ((uint64_t) m < n) {
+        uint64_t threshold = -n % n;
+        while ((uint64_t) m < threshold)
+            m = (__uint128_t) mt19937_rand() * n;
+    }
+    return m >> 64;
 }
 
+/* Shuffle a NULL-terminated list of n nodes without extra memory: shuffle both
+ * halves, then merge them taking each next node from a half with probability
+ * proportional to the number of nodes left in it. O(n log n), used when the
+ * index array of q_shuffle() cannot be allocated.
+ */
+static struct list_head *shuffle_merge(struct list_head *list, size_t n)
+{
+    if (n < 2)
+        return list;
+
+    size_t na = n / 2, nb = n - n / 2;
+    struct list_head *a = list, *b, *mid = list;
+    for (size_t i = 1; i < na; i++)
+        mid = mid->next;
+    b = mid->next;
+    mid->next = NULL;
+    a = shuffle_merge(a, na);
+    b = shuffle_merge(b, nb);
+
+    struct list_head *result = NULL, **tail = &result;
+    while (na && nb) {
+        if (rand_below(na + nb) < na) {
+            *tail = a;
+            a = a->next;
+            na--;
+        } else {
+            *tail = b;
+            b = b->next;
+            nb--;
+        }
+        tail = &(*tail)->next;
+    }
+    *tail = na ? a : b;
+    return result;
+}
+
+/* Fisher-Yates shuffle over an array of the node pointers, then relink */
 void q_shuffle(struct list_head *head)
 {
-    if (!head || list_is_singular(head))
+    if (!head || list_empty(head) || list_is_singular(head))
         return;
+    q_unindex(head);
 
-    int len = q_size(head), i, j;
-    struct list_head *move = head->prev, *tmp = NULL;
-    for (i = 0; i < len; ++i, move = move->prev) {
-        int rand_n = rand() % (len - i);
-        if (rand_n == len - i - 1)
-            continue;
-        for (j = 0, tmp = head->next; j < rand_n; ++j) {
-            tmp = tmp->next;
-        }
-        swap(tmp, move);
-        move = tmp;
+    size_t n = q_size(head);
+    struct list_head **nodes = malloc(n * sizeof(*nodes));
+    if (!nodes) {
+        head->prev->next = NULL;
+        build_prev_link(head, head, shuffle_merge(head->next, n));
+        return;
+    }
+
+    size_t i = 0;
+    struct list_head *node;
+    list_for_each_prefetch (node, head)
+        nodes[i++] = node;
+
+    for (i = n - 1; i > 0; i--) {
+        size_t j = rand_below(i + 1);
+        struct list_head *tmp = nodes[i];
+        nodes[i] = nodes[j];
+        nodes[j] = tmp;
+    }
+
+    struct list_head *prev = head;
+    for (i = 0; i < n; i++) {
+        prev->next = nodes[i];
+        nodes[i]->prev = prev;
+        prev = nodes[i];
     }
+    prev->next = head;
+    head->prev = prev;
+    free(nodes);
 }
 
 
 int ls_cmp(struct list_head *a, struct list_head *b)
 {
-    return strcmp(list_entry(a, element_t, list)->value,
-                  list_entry(b, element_t, list)->value);
+    return node_cmp(a, b);
 }
 
 
@@ -440,6 +1458,7 @@ void list_sort(struct list_head *head)
 
     if (list == head->prev)
         return;
+    q_unindex(head);
 
     head->prev->next = NULL;
 
@@ -494,27 +1513,48 @@ struct pair {
     struct list_head *head, *next;
 };
 
+/* Stable merge sort of a NULL-terminated list of n nodes */
+static struct list_head *ls_mergesort(struct list_head *list, size_t n)
+{
+    if (n < 2)
+        return list;
+
+    struct list_head *mid = list, *right;
+    for (size_t i = 1; i < n / 2; i++)
+        mid = mid->next;
+    right = mid->next;
+    mid->next = NULL;
+    return ls_merge(ls_mergesort(list, n / 2), ls_mergesort(right, n - n / 2));
+}
+
 static size_t stk_size;
 
-static void build_prev_link(struct list_head *head,
-                            struct list_head *tail,
-                            struct list_head *list)
-{
-    tail->next = list;
-    do {
-        list->prev = tail;
-        tail = list;
-        list = list->next;
-    } while (list);
+/* Runs shorter than this are extended, see compute_minrun() */
+static size_t minrun;
 
-    tail->next = head;
-    head->prev = tail;
+/* Consecutive wins by one run before merging switches to galloping */
+#define MIN_GALLOP 7
+
+/* Adaptive gallop threshold, lowered while galloping pays off */
+static size_t min_gallop;
+
+/* Pick minrun in [32, 64] so that n / minrun is a power of two or slightly
+ * less, which keeps the final merges balanced.
+ */
+static size_t compute_minrun(size_t n)
+{
+    size_t r = 0;
+    while (n >= 64) {
+        r |= n & 1;
+        n >>= 1;
+    }
+    return n + r;
 }
 
 static struct pair find_run(struct list_head *list)
 {
     size_t len = 1;
-    struct list_head *next = list->next, *head = list;
+    struct list_head *next = list->next, *head = list, *tail = list;
     struct pair result;
 
     if (!next) {
@@ -540,19 +1580,164 @@ static struct pair find_run(struct list_head *list)
             list = next;
             next = list->next;
         } while (next && ls_cmp(list, next) <= 0);
-        list->next = NULL;
+        tail = list;
+    }
+
+    tail->next = NULL;
+
+    /* Extend a short run to minrun: sort the following nodes and merge them
+     * in. On a list this needs fewer comparisons than insertion, which
+     * cannot bisect.
+     */
+    if (len < minrun && next) {
+        struct list_head *extra = next;
+        size_t n = 1;
+        for (; n < minrun - len && next->next; n++)
+            next = next->next;
+        tail = next;
+        next = next->next;
+        tail->next = NULL;
+        head = ls_merge(head, ls_mergesort(extra, n));
+        len += n;
     }
+
     head->prev = NULL;
     head->next->prev = (struct list_head *) len;
     result.head = head, result.next = next;
     return result;
 }
 
+/* Return the last node of the run starting at list which still goes before
+ * key, given that list itself does. Nodes that compare equal to key go before
+ * it only if strict is false. Probes 1, 2, 4, ... nodes ahead and then
+ * bisects the last gap, so only O(log k) comparisons are made to skip k nodes.
+ * The number of skipped nodes is added to *count.
+ */
+static struct list_head *gallop(struct list_head *list,
+                                struct list_head *key,
+                                bool strict,
+                                size_t *count)
+{
+    size_t step = 1, i;
+    *count += 1;
+    for (;;) {
+        struct list_head *probe = list;
+        for (i = 0; i < step && probe->next; i++)
+            probe = probe->next;
+        if (!i)
+            return list;
+
+        int r = node_cmp(probe, key);
+        if (strict ? r >= 0 : r > 0)
+            break;
+        list = probe;
+        *count += i;
+        if (i < step)
+            return list;
+        step <<= 1;
+    }
+
+    /* list goes before key and the node i steps ahead does not */
+    while (i > 1) {
+        size_t half = i / 2;
+        struct list_head *mid = list;
+        for (size_t j = 0; j < half; j++)
+            mid = mid->next;
+        int r = node_cmp(mid, key);
+        if (strict ? r < 0 : r <= 0) {
+            list = mid;
+            *count += half;
+            i -= half;
+        } else {
+            i = half;
+        }
+    }
+    return list;
+}
+
+/* Stable merge of two NULL-terminated runs, a preceding b. Nodes are taken
+ * one at a time until one run wins min_gallop times in a row, then whole
+ * stretches are found with gallop() and spliced in at once.
+ */
+static struct list_head *gallop_merge(struct list_head *a, struct list_head *b)
+{
+    struct list_head *head = NULL, **tail = &head, *last;
+    size_t threshold = min_gallop, wins_a, wins_b;
+
+    for (;;) {
+        if (node_cmp(a, b) > 0)
+            goto take_b;
+
+        /* a goes first; take from a until b is strictly less */
+    take_a:
+        wins_a = 0;
+        do {
+            *tail = a;
+            tail = &a->next;
+            a = a->next;
+            if (!a)
+                goto out_b;
+            if (++wins_a >= threshold)
+                goto gallop;
+        } while (node_cmp(a, b) <= 0);
+
+        /* b goes first; take from b until a is not greater */
+    take_b:
+        wins_b = 0;
+        do {
+            *tail = b;
+            tail = &b->next;
+            b = b->next;
+            if (!b)
+                goto out_a;
+            if (++wins_b >= threshold)
+                goto gallop;
+        } while (node_cmp(b, a) < 0);
+        goto take_a;
+
+    gallop:
+        threshold++;
+        do {
+            threshold -= threshold > 1;
+
+            wins_a = 0;
+            if (node_cmp(a, b) <= 0) {
+                last = gallop(a, b, false, &wins_a);
+                *tail = a;
+                tail = &last->next;
+                a = last->next;
+                if (!a)
+                    goto out_b;
+            }
+
+            wins_b = 0;
+            if (node_cmp(b, a) < 0) {
+                last = gallop(b, a, true, &wins_b);
+                *tail = b;
+                tail = &last->next;
+                b = last->next;
+                if (!b)
+                    goto out_a;
+            }
+        } while (wins_a >= MIN_GALLOP || wins_b >= MIN_GALLOP);
+        threshold++;
+    }
+
+out_a:
+    *tail = a;
+    min_gallop = threshold;
+    return head;
+out_b:
+    *tail = b;
+    min_gallop = threshold;
+    return head;
+}
+
 static struct list_head *merge_at(struct list_head *at)
 {
     size_t len = run_size(at) + run_size(at->prev);
     struct list_head *prev = at->prev->prev;
-    struct list_head *list = ls_merge(at->prev, at);
+    struct list_head *list = gallop_merge(at->prev, at);
     list->prev = prev;
     list->next->prev = (struct list_head *) len;
     --stk_size;
@@ -597,10 +1782,13 @@ static struct list_head *merge_collapse(struct list_head *tp)
 void timsort(struct list_head *head)
 {
     stk_size = 0;
+    min_gallop = MIN_GALLOP;
 
     struct list_head *list = head->next, *tp = NULL;
     if (head == head->prev)
         return;
+    q_unindex(head);
+    minrun = compute_minrun(q_size(head));
 
     /* Convert to a null-terminated singly-linked list. */
     head->prev->next = NULL;
@@ -627,4 +1815,125 @@ void timsort(struct list_head *head)
         return;
     }
     merge_final(head, stk1, stk0);
-}
\ No newline at end of file
+}
+
+
+/* Buckets smaller than this are finished by merge sort */
+#define RADIX_CUTOFF 16
+
+/* Below this depth buckets are finished by merge sort as well, which bounds
+ * the stack used by the bucket arrays of the recursion.
+ */
+#define RADIX_MAX_DEPTH 64
+
+/* Byte d of the string of node, taken from the cached key while possible so
+ * that the string itself is not touched.
+ */
+static inline unsigned char radix_byte(const struct list_head *node, size_t d)
+{
+    const node_t *n = container_of(node, node_t, e.list);
+    if (d < sizeof(n->key))
+        return n->key >> (8 * (sizeof(n->key) - 1 - d));
+    return n->e.value[d];
+}
+
+/* Stable merge of runs whose strings share their first d bytes */
+static struct list_head *radix_merge(struct list_head *a,
+                                     struct list_head *b,
+                                     size_t d,
+                                     bool descend)
+{
+    struct list_head *head = NULL, **tail = &head;
+    while (a && b) {
+        int r = strcmp(list_entry(a, element_t, list)->value + d,
+                       list_entry(b, element_t, list)->value + d);
+        if (descend ? r >= 0 : r <= 0) {
+            *tail = a;
+            a = a->next;
+        } else {
+            *tail = b;
+            b = b->next;
+        }
+        tail = &(*tail)->next;
+    }
+    *tail = a ? a : b;
+    return head;
+}
+
+static struct list_head *radix_mergesort(struct list_head *list,
+                                         size_t n,
+                                         size_t d,
+                                         bool descend)
+{
+    if (n < 2)
+        return list;
+
+    struct list_head *mid = list, *right;
+    for (size_t i = 1; i < n / 2; i++)
+        mid = mid->next;
+    right = mid->next;
+    mid->next = NULL;
+    return radix_merge(radix_mergesort(list, n / 2, d, descend),
+                       radix_mergesort(right, n - n / 2, d, descend), d,
+                       descend);
+}
+
+/* Sort the NULL-terminated list of n nodes whose strings share their first d
+ * bytes, link it at *out and return where the next node has to be linked.
+ * Nodes are distributed into buckets by byte d in order, so the sort is
+ * stable. Strings ending at d all compare equal and need no further work.
+ */
+static struct list_head **msd_radix(struct list_head *list,
+                                    size_t n,
+                                    size_t d,
+                                    bool descend,
+                                    struct list_head **out)
+{
+    if (n < RADIX_CUTOFF || d >= RADIX_MAX_DEPTH) {
+        list = radix_mergesort(list, n, d, descend);
+        *out = list;
+        while (list->next)
+            list = list->next;
+        return &list->next;
+    }
+
+    struct list_head *heads[256], **tails[256];
+    size_t counts[256] = {0};
+    for (int c = 0; c < 256; c++)
+        tails[c] = &heads[c];
+
+    for (struct list_head *node = list; node; node = node->next) {
+        unsigned char c = radix_byte(node, d);
+        *tails[c] = node;
+        tails[c] = &node->next;
+        counts[c]++;
+    }
+
+    /* Shorter strings go first in ascending order and last in descending */
+    for (int i = 0; i < 256; i++) {
+        int c = descend ? 255 - i : i;
+        if (!counts[c])
+            continue;
+        *tails[c] = NULL;
+        if (c == 0 || counts[c] == 1) {
+            *out = heads[c];
+            out = tails[c];
+        } else {
+            out = msd_radix(heads[c], counts[c], d + 1, descend, out);
+        }
+    }
+    return out;
+}
+
+void radixsort(struct list_head *head, bool descend)
+{
+    if (list_empty(head) || list_is_singular(head))
+        return;
+    q_unindex(head);
+
+    struct list_head *list = NULL, **tail;
+    head->prev->next = NULL;
+    tail = msd_radix(head->next, q_size(head), 0, descend, &list);
+    *tail = NULL;
+    build_prev_link(head, head, list);
+}
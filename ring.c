@@ -0,0 +1,148 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "element.h"
+#include "ring.h"
+
+/* Blocks from malloc are not aligned to cache lines, so the members of each
+ * thread are kept apart by a whole line of padding instead.
+ */
+#define CACHE_LINE 64
+
+/* Elements allocated ahead of each enqueue in ring_insert_tail() */
+#define RING_BATCH 64
+
+/**
+ * struct ring - SPSC ring state
+ * @head: index of the oldest element, written by the consumer only
+ * @tail_cache: the consumer's last view of @tail
+ * @tail: index one past the newest element, written by the producer only
+ * @head_cache: the producer's last view of @head
+ * @mask: capacity minus one
+ * @slots: the elements, indexed by position & @mask
+ *
+ * The members written by the consumer, those written by the producer and
+ * the shared ones are separated by padding.
+ *
+ * Indices run freely and are only masked when a slot is accessed, so
+ * tail - head is always the number of elements.
+ */
+struct ring {
+    char pad0[CACHE_LINE];
+    size_t head;
+    size_t tail_cache;
+    char pad1[CACHE_LINE];
+    size_t tail;
+    size_t head_cache;
+    char pad2[CACHE_LINE];
+    size_t mask;
+    element_t *slots[];
+};
+
+ring_t *ring_new(size_t capacity)
+{
+    size_t cap = 1;
+    while (cap < capacity)
+        cap <<= 1;
+
+    ring_t *r = malloc(sizeof(ring_t) + cap * sizeof(element_t *));
+    if (!r)
+        return NULL;
+    r->head = r->tail_cache = 0;
+    r->tail = r->head_cache = 0;
+    r->mask = cap - 1;
+    return r;
+}
+
+void ring_free(ring_t *r)
+{
+    if (!r)
+        return;
+    for (size_t i = r->head; i != r->tail; i++)
+        release_element(r->slots[i & r->mask]);
+    free(r);
+}
+
+size_t ring_enqueue_n(ring_t *r, element_t *const *es, size_t n)
+{
+    size_t tail = r->tail;
+    size_t room = r->mask + 1 - (tail - r->head_cache);
+    if (room < n) {
+        r->head_cache = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+        room = r->mask + 1 - (tail - r->head_cache);
+    }
+    if (n > room)
+        n = room;
+
+    for (size_t i = 0; i < n; i++)
+        r->slots[(tail + i) & r->mask] = es[i];
+    __atomic_store_n(&r->tail, tail + n, __ATOMIC_RELEASE);
+    return n;
+}
+
+size_t ring_dequeue_n(ring_t *r, element_t **es, size_t n)
+{
+    size_t head = r->head;
+    size_t avail = r->tail_cache - head;
+    if (avail < n) {
+        r->tail_cache = __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+        avail = r->tail_cache - head;
+    }
+    if (n > avail)
+        n = avail;
+
+    for (size_t i = 0; i < n; i++)
+        es[i] = r->slots[(head + i) & r->mask];
+    __atomic_store_n(&r->head, head + n, __ATOMIC_RELEASE);
+    return n;
+}
+
+size_t ring_insert_tail(ring_t *r, char *s, size_t n)
+{
+    element_t *batch[RING_BATCH];
+    size_t done = 0;
+    while (done < n) {
+        size_t want = n - done < RING_BATCH ? n - done : RING_BATCH;
+        size_t made = 0;
+        while (made < want && !new_malloc_element(&batch[made], s))
+            made++;
+
+        size_t put = ring_enqueue_n(r, batch, made);
+        for (size_t i = put; i < made; i++)
+            release_element(batch[i]);
+        done += put;
+        if (put < want)
+            break;
+    }
+    return done;
+}
+
+element_t *ring_remove_head(ring_t *r, char *sp, size_t bufsize)
+{
+    element_t *e;
+    if (!ring_dequeue_n(r, &e, 1))
+        return NULL;
+    if (sp) {
+        strncpy(sp, e->value, bufsize);
+        sp[bufsize - 1] = '\0';
+    }
+    return e;
+}
+
+element_t *ring_at(ring_t *r, size_t i)
+{
+    size_t tail = __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+    return i < tail - r->head ? r->slots[(r->head + i) & r->mask] : NULL;
+}
+
+size_t ring_size(const ring_t *r)
+{
+    return __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE) -
+           __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+}
+
+size_t ring_capacity(const ring_t *r)
+{
+    return r->mask + 1;
+}
@@ -0,0 +1,106 @@
+#ifndef LAB0_RING_H
+#define LAB0_RING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "queue.h"
+
+/* Bounded single-producer/single-consumer ring of element_t pointers.
+ *
+ * One thread may enqueue while another dequeues, without locks. The indices
+ * are published with release stores and read with acquire loads, and each
+ * side keeps a cached copy of the other side's index on its own cache line,
+ * so the shared lines only move when the cached view runs out. The batch
+ * calls publish a whole batch with a single store.
+ *
+ * Elements are the list queue's own, released with release_element(), but
+ * always come from malloc because the slab pool is not thread-safe.
+ */
+
+typedef struct ring ring_t;
+
+/**
+ * ring_new() - Create an empty ring
+ * @capacity: number of elements it must hold, rounded up to a power of two
+ *
+ * Return: the new ring, NULL if allocation failed.
+ */
+ring_t *ring_new(size_t capacity);
+
+/**
+ * ring_free() - Free a ring together with the elements still in it
+ * @r: ring to free, may be NULL
+ */
+void ring_free(ring_t *r);
+
+/**
+ * ring_enqueue_n() - Append up to @n elements, producer side
+ * @r: the ring
+ * @es: elements to append, in order
+ * @n: number of elements in @es
+ *
+ * Return: number of elements appended, less than @n if the ring filled up.
+ */
+size_t ring_enqueue_n(ring_t *r, element_t *const *es, size_t n);
+
+/**
+ * ring_dequeue_n() - Take up to @n of the oldest elements, consumer side
+ * @r: the ring
+ * @es: array receiving the elements, oldest first
+ * @n: capacity of @es
+ *
+ * Return: number of elements taken, 0 if the ring was empty.
+ */
+size_t ring_dequeue_n(ring_t *r, element_t **es, size_t n);
+
+/**
+ * ring_insert_tail() - Append @n copies of string @s, producer side
+ * @r: the ring
+ * @s: string to copy
+ * @n: number of copies
+ *
+ * The elements are allocated first and then appended with one
+ * ring_enqueue_n() call per batch.
+ *
+ * Return: number of copies appended, less than @n if allocation failed or
+ * the ring filled up.
+ */
+size_t ring_insert_tail(ring_t *r, char *s, size_t n);
+
+/**
+ * ring_remove_head() - Take the oldest element, consumer side
+ * @r: the ring
+ * @sp: string would be inserted
+ * @bufsize: size of the string
+ *
+ * If @sp is non-NULL, the string is copied into it as q_remove_head() does.
+ *
+ * Return: the element, NULL if the ring was empty.
+ */
+element_t *ring_remove_head(ring_t *r, char *sp, size_t bufsize);
+
+/**
+ * ring_at() - Element @i places behind the oldest one, consumer side
+ * @r: the ring
+ * @i: position, 0 for the oldest element
+ *
+ * Return: the element, NULL if the ring holds @i elements or fewer.
+ */
+element_t *ring_at(ring_t *r, size_t i);
+
+/**
+ * ring_size() - Number of elements in the ring
+ * @r: the ring
+ *
+ * Exact only while neither side is running concurrently.
+ */
+size_t ring_size(const ring_t *r);
+
+/**
+ * ring_capacity() - Maximum number of elements the ring holds
+ * @r: the ring
+ */
+size_t ring_capacity(const ring_t *r);
+
+#endif /* LAB0_RING_H */
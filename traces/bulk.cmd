@@ -0,0 +1,31 @@
+# Test of repeated insertions performed with the bulk API
+option fail 0
+option malloc 0
+option bulk 1
+new
+it b 3
+ih a 2
+it c 2
+rh a
+rh a
+rh b
+rt c
+rt c
+ih RAND 2000
+it RAND 2000
+size
+sort
+free
+new
+time ih dolphin 1000000
+time it gerbil 1000000
+size
+rh dolphin
+rt gerbil
+reverse
+rh gerbil
+free
+option bulk 0
+new
+time it gerbil 1000000
+free
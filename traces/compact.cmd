@@ -0,0 +1,29 @@
+# Test of moving a scattered queue into one block
+option fail 0
+option malloc 0
+option timeout 10
+new
+it b
+ih a
+it c
+compact
+rh a
+it d
+compact
+rt d
+rh b
+rh c
+compact
+size
+free
+new
+ih RAND 1000000
+shuffle
+sort
+time reverse
+time reverse
+time compact
+time reverse
+time reverse
+dedup hash
+free
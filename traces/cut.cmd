@@ -0,0 +1,39 @@
+# Test of moving ranges of elements to new queues
+option fail 0
+option malloc 0
+new
+it a
+it b
+it c
+it d
+it e
+it f
+it g
+rhn 2
+rh a
+rh b
+free
+rtn 2
+rh f
+rh g
+free
+cut 1 2
+rh d
+free
+size
+rh c
+rh e
+cut 0 0
+size
+free
+free
+new
+it dolphin 1000000
+time rhn 1000
+free
+time rtn 1000
+free
+time cut 500000 500100
+free
+size
+free
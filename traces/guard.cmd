@@ -0,0 +1,11 @@
+# Run a million-element workload with every 32nd block against a guard page
+option fail 0
+option malloc 0
+option timeout 20
+option guard 32
+new
+time ih RAND 1000000
+time sort
+time reverse
+time free
+option guard 0
@@ -0,0 +1,62 @@
+# Test of positional access, with and without the order-statistic index
+option fail 0
+option malloc 0
+option index 1
+new
+it b
+it d
+insat 0 a
+insat 3 e
+insat 2 c
+get 0 a
+get 2 c
+get 4 e
+delat 2
+get 2 d
+ih z
+it y
+dm
+get 2 b
+get 3 e
+reverse
+get 0 y
+sort
+get 3 y
+delat 4
+rt y
+rh a
+free
+new
+it gerbil 1000000
+time insat 500000 dolphin 10000
+time get 515000 gerbil
+time delat 500000 10000
+size
+free
+option index 0
+new
+it gerbil 1000000
+time insat 500000 dolphin 100
+time delat 500000 100
+size
+free
+option index 1
+new
+it a
+it b
+it c
+get 1 b
+option index 0
+ih z
+rt c
+it d
+option index 1
+get 0 z
+get 2 b
+get 3 d
+delat 1
+get 1 b
+ih y
+get 0 y
+get 3 d
+free
@@ -0,0 +1,43 @@
+# Test of sharing one copy of equal strings
+option fail 0
+option malloc 0
+option intern 1
+new
+ih dolphin
+ih dolphin
+it gerbil
+it gerbil 3
+ih bear
+sort
+dedup
+rh bear
+size
+option intern 0
+it gerbil
+it gerbil
+option intern 1
+it gerbil
+it zebra
+dedup
+rh zebra
+size
+new
+it dolphin 1000
+compact
+rt dolphin
+merge
+dedup
+size
+free
+new
+time ih a_rather_long_value_shared_by_every_element 1000000
+time dedup
+time it RAND 100000
+sort
+time dedup hash
+free
+option intern 0
+new
+time ih a_rather_long_value_shared_by_every_element 1000000
+time dedup
+free
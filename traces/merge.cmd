@@ -0,0 +1,3091 @@
+# Test of merging 256 sorted queues with the heap and in pairwise rounds
+option fail 0
+option malloc 0
+option mergemode 0
+option descend 0
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+time merge
+free
+option mergemode 1
+option descend 0
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+time merge
+free
+option mergemode 0
+option descend 1
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+time merge
+free
+option mergemode 1
+option descend 1
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+new
+ih RAND 80
+sort
+new
+ih RAND 100
+sort
+new
+ih RAND 120
+sort
+new
+ih RAND 0
+sort
+new
+ih RAND 20
+sort
+new
+ih RAND 40
+sort
+new
+ih RAND 60
+sort
+time merge
+free
@@ -0,0 +1,21 @@
+# Free list and ring queues while the mpmc queue still holds elements
+option fail 0
+option malloc 0
+new
+it dolphin
+mpnew
+mpit a 3
+mprh a
+free
+mprh a
+mpfree
+option backend ring
+new
+it gerbil 3
+mpnew
+mpit b 2
+free
+mprh b
+mprh b
+mpfree
+option backend list
@@ -0,0 +1,18 @@
+# Check FIFO order of the lock-free mpmc queue, then measure its throughput
+# with 1, 2, 4 and 8 producer/consumer pairs
+option fail 0
+option malloc 0
+option timeout 10
+mpnew
+mpit dolphin
+mpit bear 2
+mpit gerbil
+mprh dolphin
+mprh bear
+mprh bear
+mprh gerbil
+mpfree
+mpbench 1 1 1000000
+mpbench 2 2 1000000
+mpbench 4 4 1000000
+mpbench 8 8 1000000
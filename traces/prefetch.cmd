@@ -0,0 +1,12 @@
+# Test of traversal performance on a queue scattered over the heap
+option fail 0
+option malloc 0
+option timeout 10
+new
+ih RAND 1000000
+shuffle
+time reverse
+time sort
+shuffle
+time dedup hash
+time free
@@ -0,0 +1,30 @@
+# Compare sorting 1000000 random strings with and without cached key prefixes
+option fail 0
+option malloc 0
+option timeout 10
+option prefix 0
+new
+ih RAND 1000000
+time sort
+free
+new
+ih RAND 1000000
+time listsort
+free
+new
+ih RAND 1000000
+time timsort
+free
+option prefix 1
+new
+ih RAND 1000000
+time sort
+free
+new
+ih RAND 1000000
+time listsort
+free
+new
+ih RAND 1000000
+time timsort
+free
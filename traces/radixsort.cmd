@@ -0,0 +1,18 @@
+# Compare radixsort with list_sort and timsort on 500000 random strings in
+# both orders
+option fail 0
+option malloc 0
+option timeout 10
+new
+ih RAND 500000
+time radixsort
+shuffle
+time listsort
+shuffle
+time timsort
+option descend 1
+shuffle
+time radixsort
+shuffle
+time sort
+free
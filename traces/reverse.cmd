@@ -0,0 +1,13 @@
+# Test of reversal performance on a long queue
+option fail 0
+option malloc 0
+option timeout 10
+new
+it RAND 2000000
+time reverseK 7
+time reverse
+time reverseK 2000000
+shuffle
+time reverseK 7
+time reverse
+free
@@ -0,0 +1,7 @@
+# ringbench stops and reports when its producer cannot allocate elements
+option verbose 1
+option failafter 20000
+ringbench 100000 8 64
+option failafter 0
+option verbose 4
+ringbench 1000 8 64
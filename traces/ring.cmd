@@ -0,0 +1,22 @@
+# Test of the SPSC ring backend and its batched throughput
+option backend ring
+new
+it a
+it b 3
+it c
+size
+rh a
+rh b
+rh b
+rh b
+rh c
+size
+it d 2000
+free
+option backend list
+new
+ih list
+rh list
+free
+ringbench 200000 1 1024
+ringbench 200000 32 1024
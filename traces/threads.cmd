@@ -0,0 +1,31 @@
+# Test of sorting on several threads
+option fail 0
+option malloc 0
+option threads 2
+new
+ih RAND 10000
+sort
+option descend 1
+sort
+option descend 0
+free
+option threads 4
+new
+ih RAND 20000
+sort
+option descend 1
+sort
+reverse
+sort
+option descend 0
+sort
+free
+new
+ih RAND 100
+it RAND 100
+sort
+option descend 1
+sort
+option descend 0
+free
+option threads 1
@@ -0,0 +1,38 @@
+# Compare timsort and list_sort on sorted, reverse-sorted, sawtooth and
+# random input of 500000 strings
+option fail 0
+option malloc 0
+option timeout 10
+new
+ih RAND 500000
+sort
+time timsort
+time listsort
+free
+new
+ih RAND 500000
+sort
+reverse
+time timsort
+reverse
+time listsort
+free
+new
+ih RAND 500000
+option descend 1
+sort
+option descend 0
+reverseK 1000
+time timsort
+option descend 1
+sort
+option descend 0
+reverseK 1000
+time listsort
+free
+new
+ih RAND 500000
+time timsort
+shuffle
+time listsort
+free
@@ -0,0 +1,23 @@
+# Compare traversal heavy operations of the unrolled backend with the list on
+# 1000000 random strings
+option fail 0
+option malloc 0
+option timeout 10
+new
+it RAND 1000000
+time reverse
+time reverseK 3
+time swap
+time sort
+time dm
+free
+option backend unroll
+new
+it RAND 1000000
+time reverse
+time reverseK 3
+time swap
+time sort
+time dm
+free
+option backend list
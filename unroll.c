@@ -0,0 +1,500 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "element.h"
+#include "unroll.h"
+
+/**
+ * chunk_t - Block of consecutive elements of an unrolled queue
+ * @list: links to the neighbouring chunks
+ * @begin: first used slot
+ * @end: one past the last used slot
+ * @items: the elements, in queue order
+ *
+ * A chunk in a queue is never empty, it is freed as soon as its last element
+ * goes away.
+ */
+typedef struct {
+    struct list_head list;
+    int begin, end;
+    element_t *items[UNROLL_CHUNK];
+} chunk_t;
+
+#define chunk_of(node) list_entry(node, chunk_t, list)
+
+/**
+ * unroll_head_t - Header of a queue returned by unroll_new()
+ * @chunks: the chunk list, whose head is handed out to callers
+ * @size: number of elements
+ */
+typedef struct {
+    struct list_head chunks;
+    int size;
+} unroll_head_t;
+
+#define u_head(head) container_of(head, unroll_head_t, chunks)
+
+static inline int chunk_count(const chunk_t *c)
+{
+    return c->end - c->begin;
+}
+
+/* Allocate an empty chunk that grows in both directions from slot pos */
+static chunk_t *chunk_new(int pos)
+{
+    chunk_t *c = malloc(sizeof(chunk_t));
+    if (c)
+        c->begin = c->end = pos;
+    return c;
+}
+
+static void chunk_del(chunk_t *c)
+{
+    list_del(&c->list);
+    free(c);
+}
+
+static inline element_t **iter_slot(const unroll_iter_t *it)
+{
+    return &chunk_of(it->chunk)->items[it->i];
+}
+
+static inline void iter_begin(struct list_head *head, unroll_iter_t *it)
+{
+    it->chunk = head->next;
+    if (it->chunk != head)
+        it->i = chunk_of(it->chunk)->begin;
+}
+
+static inline void iter_rbegin(struct list_head *head, unroll_iter_t *it)
+{
+    it->chunk = head->prev;
+    if (it->chunk != head)
+        it->i = chunk_of(it->chunk)->end - 1;
+}
+
+static inline void iter_next(struct list_head *head, unroll_iter_t *it)
+{
+    if (++it->i < chunk_of(it->chunk)->end)
+        return;
+    it->chunk = it->chunk->next;
+    if (it->chunk != head)
+        it->i = chunk_of(it->chunk)->begin;
+}
+
+static inline void iter_prev(struct list_head *head, unroll_iter_t *it)
+{
+    if (--it->i >= chunk_of(it->chunk)->begin)
+        return;
+    it->chunk = it->chunk->prev;
+    if (it->chunk != head)
+        it->i = chunk_of(it->chunk)->end - 1;
+}
+
+/* Move forward by n elements, stepping over whole chunks at a time */
+static void iter_advance(struct list_head *head, unroll_iter_t *it, int n)
+{
+    while (it->chunk != head) {
+        chunk_t *c = chunk_of(it->chunk);
+        if (n < c->end - it->i) {
+            it->i += n;
+            return;
+        }
+        n -= c->end - it->i;
+        it->chunk = it->chunk->next;
+        if (it->chunk != head)
+            it->i = chunk_of(it->chunk)->begin;
+    }
+}
+
+/* Drop the slots from w to the tail, freeing the chunks left empty */
+static void truncate_after(struct list_head *head, const unroll_iter_t *w)
+{
+    if (w->chunk == head)
+        return;
+
+    chunk_t *c = chunk_of(w->chunk);
+    c->end = w->i;
+    struct list_head *node = c->begin == c->end ? &c->list : c->list.next;
+    while (node != head) {
+        struct list_head *next = node->next;
+        chunk_del(chunk_of(node));
+        node = next;
+    }
+}
+
+/* Drop the slots from the head to w, freeing the chunks left empty */
+static void truncate_before(struct list_head *head, const unroll_iter_t *w)
+{
+    if (w->chunk == head)
+        return;
+
+    chunk_t *c = chunk_of(w->chunk);
+    c->begin = w->i + 1;
+    struct list_head *node = c->begin == c->end ? &c->list : c->list.prev;
+    while (node != head) {
+        struct list_head *prev = node->prev;
+        chunk_del(chunk_of(node));
+        node = prev;
+    }
+}
+
+/* Link the elements in queue order through their own list nodes */
+static struct list_head *chain_elements(struct list_head *head)
+{
+    struct list_head *first = NULL, **link = &first;
+    chunk_t *c;
+    list_for_each_entry (c, head, list) {
+        for (int i = c->begin; i < c->end; i++) {
+            *link = &c->items[i]->list;
+            link = &(*link)->next;
+        }
+    }
+    *link = NULL;
+    return first;
+}
+
+/* Store the chained elements into the used slots of the queue, in order */
+static void refill(struct list_head *head, struct list_head *node)
+{
+    chunk_t *c;
+    list_for_each_entry (c, head, list) {
+        for (int i = c->begin; i < c->end; i++, node = node->next)
+            c->items[i] = list_entry(node, element_t, list);
+    }
+}
+
+struct list_head *unroll_new()
+{
+    unroll_head_t *h = malloc(sizeof(unroll_head_t));
+    if (!h)
+        return NULL;
+    INIT_LIST_HEAD(&h->chunks);
+    h->size = 0;
+    return &h->chunks;
+}
+
+void unroll_free(struct list_head *head)
+{
+    if (!head)
+        return;
+
+    chunk_t *c, *safe;
+    list_for_each_entry_safe (c, safe, head, list) {
+        for (int i = c->begin; i < c->end; i++)
+            release_element(c->items[i]);
+        free(c);
+    }
+    free(u_head(head));
+}
+
+bool unroll_insert_head(struct list_head *head, char *s)
+{
+    element_t *e;
+    if (!head || new_element(&e, s))
+        return false;
+
+    chunk_t *c = list_empty(head) ? NULL : chunk_of(head->next);
+    if (!c || !c->begin) {
+        c = chunk_new(UNROLL_CHUNK);
+        if (!c) {
+            release_element(e);
+            return false;
+        }
+        list_add(&c->list, head);
+    }
+    c->items[--c->begin] = e;
+    u_head(head)->size++;
+    return true;
+}
+
+bool unroll_insert_tail(struct list_head *head, char *s)
+{
+    element_t *e;
+    if (!head || new_element(&e, s))
+        return false;
+
+    chunk_t *c = list_empty(head) ? NULL : chunk_of(head->prev);
+    if (!c || c->end == UNROLL_CHUNK) {
+        c = chunk_new(0);
+        if (!c) {
+            release_element(e);
+            return false;
+        }
+        list_add_tail(&c->list, head);
+    }
+    c->items[c->end++] = e;
+    u_head(head)->size++;
+    return true;
+}
+
+static element_t *unroll_remove(struct list_head *head,
+                                bool tail,
+                                char *sp,
+                                size_t bufsize)
+{
+    if (!head || list_empty(head))
+        return NULL;
+
+    chunk_t *c = chunk_of(tail ? head->prev : head->next);
+    element_t *e = tail ? c->items[--c->end] : c->items[c->begin++];
+    if (c->begin == c->end)
+        chunk_del(c);
+    u_head(head)->size--;
+    if (sp) {
+        strncpy(sp, e->value, bufsize);
+        sp[bufsize - 1] = '\0';
+    }
+    return e;
+}
+
+element_t *unroll_remove_head(struct list_head *head, char *sp, size_t bufsize)
+{
+    return unroll_remove(head, false, sp, bufsize);
+}
+
+element_t *unroll_remove_tail(struct list_head *head, char *sp, size_t bufsize)
+{
+    return unroll_remove(head, true, sp, bufsize);
+}
+
+int unroll_size(struct list_head *head)
+{
+    return head ? u_head(head)->size : 0;
+}
+
+bool unroll_delete_mid(struct list_head *head)
+{
+    if (!head || list_empty(head))
+        return false;
+
+    unroll_iter_t it;
+    iter_begin(head, &it);
+    iter_advance(head, &it, unroll_size(head) / 2);
+    chunk_t *c = chunk_of(it.chunk);
+    release_element(c->items[it.i]);
+
+    /* Close the gap from whichever side of the chunk has fewer elements */
+    if (it.i - c->begin < c->end - 1 - it.i) {
+        memmove(c->items + c->begin + 1, c->items + c->begin,
+                (it.i - c->begin) * sizeof(element_t *));
+        c->begin++;
+    } else {
+        memmove(c->items + it.i, c->items + it.i + 1,
+                (c->end - 1 - it.i) * sizeof(element_t *));
+        c->end--;
+    }
+    if (c->begin == c->end)
+        chunk_del(c);
+    u_head(head)->size--;
+    return true;
+}
+
+bool unroll_delete_dup(struct list_head *head)
+{
+    if (!head || list_empty(head))
+        return false;
+    if (unroll_size(head) == 1)
+        return false;
+
+    /* Survivors are written back behind the reader, over the same slots */
+    unroll_iter_t r, w;
+    iter_begin(head, &r);
+    w = r;
+    while (r.chunk != head) {
+        element_t *e = *iter_slot(&r);
+        bool dup = false;
+        for (iter_next(head, &r);
+             r.chunk != head && !strcmp((*iter_slot(&r))->value, e->value);
+             iter_next(head, &r)) {
+            release_element(*iter_slot(&r));
+            u_head(head)->size--;
+            dup = true;
+        }
+        if (dup) {
+            release_element(e);
+            u_head(head)->size--;
+        } else {
+            *iter_slot(&w) = e;
+            iter_next(head, &w);
+        }
+    }
+    truncate_after(head, &w);
+    return true;
+}
+
+void unroll_swap(struct list_head *head)
+{
+    unroll_reverseK(head, 2);
+}
+
+void unroll_reverse(struct list_head *head)
+{
+    if (!head || list_empty(head))
+        return;
+
+    /* Reverse the chunk list and mirror every chunk, so the free slots of the
+     * old tail chunk end up in front of the new head chunk.
+     */
+    struct list_head *node = head;
+    do {
+        struct list_head *next = node->next;
+        node->next = node->prev;
+        node->prev = next;
+        if (node != head) {
+            chunk_t *c = chunk_of(node);
+            for (int i = c->begin, j = c->end - 1; i < j; i++, j--) {
+                element_t *tmp = c->items[i];
+                c->items[i] = c->items[j];
+                c->items[j] = tmp;
+            }
+            int shift = UNROLL_CHUNK - c->end - c->begin;
+            if (shift) {
+                memmove(c->items + c->begin + shift, c->items + c->begin,
+                        chunk_count(c) * sizeof(element_t *));
+                c->begin += shift;
+                c->end += shift;
+            }
+        }
+        node = next;
+    } while (node != head);
+}
+
+void unroll_reverseK(struct list_head *head, int k)
+{
+    if (!head || list_empty(head))
+        return;
+
+    /* Like q_reverseK(), a trailing group shorter than k is reversed too and
+     * k below 1 reverses the whole queue.
+     */
+    int n = unroll_size(head);
+    if (k < 1)
+        k = n;
+    unroll_iter_t front;
+    iter_begin(head, &front);
+    for (; n > 0; n -= k) {
+        int len = n < k ? n : k;
+        unroll_iter_t back = front, next;
+        iter_advance(head, &back, len - 1);
+        next = back;
+        iter_next(head, &next);
+        for (int j = 0; j < len / 2; j++) {
+            element_t *tmp = *iter_slot(&front);
+            *iter_slot(&front) = *iter_slot(&back);
+            *iter_slot(&back) = tmp;
+            iter_next(head, &front);
+            iter_prev(head, &back);
+        }
+        front = next;
+    }
+}
+
+void unroll_sort(struct list_head *head, bool descend)
+{
+    if (!head || list_empty(head))
+        return;
+
+    refill(head,
+           q_mergeSort(chain_elements(head), unroll_size(head), descend));
+}
+
+/* Remove every element followed anywhere by one that sorts strictly before
+ * it, scanning from the tail and compacting the survivors towards it.
+ */
+static int unroll_remove_unordered(struct list_head *head, bool descend)
+{
+    if (!head || list_empty(head))
+        return 0;
+
+    unroll_iter_t r, w;
+    iter_rbegin(head, &r);
+    w = r;
+    element_t *last = NULL;
+    int count = 0;
+    while (r.chunk != head) {
+        element_t *e = *iter_slot(&r);
+        iter_prev(head, &r);
+        int cmp = last ? strcmp(last->value, e->value) : 0;
+        if (descend ? cmp > 0 : cmp < 0) {
+            release_element(e);
+            continue;
+        }
+        *iter_slot(&w) = e;
+        iter_prev(head, &w);
+        last = e;
+        count++;
+    }
+    truncate_before(head, &w);
+    u_head(head)->size = count;
+    return count;
+}
+
+int unroll_ascend(struct list_head *head)
+{
+    return unroll_remove_unordered(head, false);
+}
+
+int unroll_descend(struct list_head *head)
+{
+    return unroll_remove_unordered(head, true);
+}
+
+/* Pending merged runs; run i holds the elements of 2^i queues */
+#define MERGE_RUNS 32
+
+int unroll_merge(struct list_head *head, bool descend)
+{
+    if (!head || list_empty(head))
+        return 0;
+
+    struct list_head *runs[MERGE_RUNS] = {NULL};
+    struct list_head *first = list_first_entry(head, queue_contex_t, chain)->q;
+    queue_contex_t *ctx;
+    int size = 0;
+    list_for_each_entry (ctx, head, chain) {
+        size += unroll_size(ctx->q);
+        struct list_head *carry = chain_elements(ctx->q);
+        int i;
+        for (i = 0; i < MERGE_RUNS - 1 && runs[i]; i++) {
+            carry = merge(runs[i], carry, descend);
+            runs[i] = NULL;
+        }
+        runs[i] = runs[i] ? merge(runs[i], carry, descend) : carry;
+        if (ctx->q != first) {
+            list_splice_tail_init(ctx->q, first);
+            u_head(ctx->q)->size = 0;
+        }
+    }
+
+    struct list_head *merged = NULL;
+    for (int i = 0; i < MERGE_RUNS; i++) {
+        if (runs[i])
+            merged = merged ? merge(runs[i], merged, descend) : runs[i];
+    }
+    refill(first, merged);
+    u_head(first)->size = size;
+    return size;
+}
+
+element_t *unroll_first(struct list_head *head, unroll_iter_t *it)
+{
+    if (!head || list_empty(head))
+        return NULL;
+    iter_begin(head, it);
+    return *iter_slot(it);
+}
+
+element_t *unroll_next(struct list_head *head, unroll_iter_t *it)
+{
+    iter_next(head, it);
+    return it->chunk == head ? NULL : *iter_slot(it);
+}
+
+element_t *unroll_last(struct list_head *head)
+{
+    if (!head || list_empty(head))
+        return NULL;
+    chunk_t *c = chunk_of(head->prev);
+    return c->items[c->end - 1];
+}
@@ -0,0 +1,96 @@
+#ifndef LAB0_UNROLL_H
+#define LAB0_UNROLL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "queue.h"
+
+/* Unrolled queue of element_t.
+ *
+ * Instead of one list node per element, the queue is a circular list of
+ * chunks holding up to UNROLL_CHUNK element pointers each, so walking it
+ * touches one list node per chunk and reads the pointers in between
+ * sequentially. Every chunk keeps its elements in the contiguous slots
+ * [begin, end), which lets both ends of the queue grow and shrink in O(1).
+ *
+ * The functions mirror those of queue.h and take the same struct list_head
+ * handle, which here is the head of the chunk list. The elements are those of
+ * the list based queue, but their list links are unused except as scratch
+ * space while sorting and merging.
+ */
+
+/* Element pointers per chunk, 512 bytes or eight cache lines */
+#define UNROLL_CHUNK 64
+
+/**
+ * unroll_iter_t - Position of an element in an unrolled queue
+ * @chunk: list node of the chunk holding it, the queue head past the end
+ * @i: slot of the element in that chunk
+ */
+typedef struct {
+    struct list_head *chunk;
+    int i;
+} unroll_iter_t;
+
+/* Create an empty queue, NULL if allocation failed */
+struct list_head *unroll_new();
+
+/* Free all storage used by the queue, @head may be NULL */
+void unroll_free(struct list_head *head);
+
+/* Insert a copy of @s at the head or tail, false if allocation failed */
+bool unroll_insert_head(struct list_head *head, char *s);
+bool unroll_insert_tail(struct list_head *head, char *s);
+
+/* Remove the first or last element as q_remove_head() does */
+element_t *unroll_remove_head(struct list_head *head, char *sp, size_t bufsize);
+element_t *unroll_remove_tail(struct list_head *head, char *sp, size_t bufsize);
+
+/* Number of elements */
+int unroll_size(struct list_head *head);
+
+/* The remaining operations behave exactly like their q_ counterparts */
+bool unroll_delete_mid(struct list_head *head);
+bool unroll_delete_dup(struct list_head *head);
+void unroll_swap(struct list_head *head);
+void unroll_reverse(struct list_head *head);
+void unroll_reverseK(struct list_head *head, int k);
+void unroll_sort(struct list_head *head, bool descend);
+int unroll_ascend(struct list_head *head);
+int unroll_descend(struct list_head *head);
+
+/**
+ * unroll_merge() - Merge all queues of a chain into the first one
+ * @head: chain of queue_contex_t whose queues are unrolled queues
+ * @descend: whether the queues are sorted in descending order
+ *
+ * The chunks of the other queues are moved to the first queue and refilled,
+ * so merging neither allocates nor frees memory.
+ *
+ * Return: number of elements in the merged queue.
+ */
+int unroll_merge(struct list_head *head, bool descend);
+
+/**
+ * unroll_first() - First element of a queue
+ * @head: the queue
+ * @it: receives the position of the element
+ *
+ * Return: the element, NULL if the queue is empty.
+ */
+element_t *unroll_first(struct list_head *head, unroll_iter_t *it);
+
+/**
+ * unroll_next() - Element following the one at @it
+ * @head: the queue
+ * @it: position, advanced to the returned element
+ *
+ * Return: the element, NULL past the last one.
+ */
+element_t *unroll_next(struct list_head *head, unroll_iter_t *it);
+
+/* Last element of a queue, NULL if it is empty */
+element_t *unroll_last(struct list_head *head);
+
+#endif /* LAB0_UNROLL_H */